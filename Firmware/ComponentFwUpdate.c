@@ -1,542 +1,4365 @@
-/*++
-    This file is part of Component Firmware Update (CFU), licensed under
-    the MIT License (MIT).
-
-    Copyright (c) Microsoft Corporation. All rights reserved.
-
-    Permission is hereby granted, free of charge, to any person obtaining a copy
-    of this software and associated documentation files (the "Software"), to deal
-    in the Software without restriction, including without limitation the rights
-    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-    copies of the Software, and to permit persons to whom the Software is
-    furnished to do so, subject to the following conditions:
-
-    The above copyright notice and this permission notice shall be included in all
-    copies or substantial portions of the Software.
-
-    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-    SOFTWARE.
-
-Module Name:
-
-    ComponentFwUpdate.c
-
-Abstract:
-
-    Implementation of the component firmware update protocol.
-
-Environment:
-
-    Firmware driver. 
---*/
-//****************************************************************************
-//
-//                               INCLUDES
-//
-//****************************************************************************
-#include <stdlib.h>
-#include "coretypes.h"
-#include "ComponentFwUpdate.h"
-#include "ICompFwUpdateBsp.h"
-#include "IComponentFirmwareUpdate.h"
-#include "FwVersion.h"
-
-#define CPFWU_REVISION  (2u)
-
-//****************************************************************************
-//
-//                                  DEFINES
-//
-//****************************************************************************
-// Developer TODO  - Modify Timer functionality to meet your platform needs.
-typedef UINT16 TIMER_ID; // change this to your needs for timer definition
-TIMER_ID BSP_Timer_Create ( void (* pTimerCallback)(void), UINT32 timeoutMs){return (TIMER_ID) 1;}
-void BSP_Timer_Stop(TIMER_ID timerId){}
-void BSP_Timer_Restart(TIMER_ID timerId){}
-// 
-
-// Maximum time for a single image update to finish.
-//   if it takes longer than this - the CFU engine is reset.
-// Developer TODO  - set your own time out value
-#define MAX_FW_UPDATE_TIME_FAIL_SAFE_MS         (20 * 60 * 1000)
-
-//****************************************************************************
-//
-//                                  TYPEDEFS
-//
-//****************************************************************************
-typedef struct
-{
-    UINT8   activeComponentId;
-    BOOL    forceReset;
-    BOOL    updateInProgress;
-} CURRENT_OFFER_INFO;
-
-//****************************************************************************
-//
-//                              STATIC VARIABLES
-//
-//****************************************************************************
-static CURRENT_OFFER_INFO       s_currentOffer;
-static COMPONENT_REGISTRATION*  s_pFirstComponentIFace = NULL;
-static TIMER_ID                 s_updateTimer = 0; //BSP Modify initial value 
-                                                   // to your platform needs
-static BOOL                     s_bankSwapPending = FALSE;
-//****************************************************************************
-//
-//                          STATIC FUNCTION PROTOTYPES
-//
-//****************************************************************************
-static void _ReadCompleteCallback(void);
-static void _UpdateTimerCallback(void);
-static UINT32 FirmwareUpdateInit(void);
-//****************************************************************************
-//
-//                              GLOBAL VARIABLES
-//
-//****************************************************************************
-
-//****************************************************************************
-//
-//                              FUNCTION CODE
-//
-//****************************************************************************
-
-//****************************************************************************
-//
-// _ReadCompleteCallback - Callback when component is done with image.
-//
-//****************************************************************************
-static void _ReadCompleteCallback(void)
-{
-    // Update of image has completed successfully. 
-    s_currentOffer.updateInProgress = FALSE;
-}
-
-static void _UpdateTimerCallback(void)
-{
-    // Note: Typically you should wrap these timer callbacks
-    //       in a thread safe construct (Critical section etc).
-    //       Some implementations have timer task as highest
-    //       priority which would mitigate the requirement for this
-    //       example.
-    
-    // Developer TODO  -Implementation of thread safety is left to developer
-    //                  (example critical section calls below)
-    //  ENTER_CRITICAL_SECTION();
-    s_currentOffer.updateInProgress = FALSE;
-    BSP_Timer_Stop(s_updateTimer);
-    //  EXIT_CRITICAL_SECTION();
-}
-
-//****************************************************************************
-//
-//                              GLOBAL FUNCTIONS
-//
-//****************************************************************************
-
-//****************************************************************************
-//
-// FirmwareUpdateInit - Initialization that needs to occur when its 
-// task starts up
-// 
-//    NOTE: This function must be called at system start up
-//
-//****************************************************************************
-UINT32 FirmwareUpdateInit(void)
-{
-    s_updateTimer = BSP_Timer_Create( _UpdateTimerCallback, 
-                                      MAX_FW_UPDATE_TIME_FAIL_SAFE_MS);
-    BSP_Timer_Stop(s_updateTimer);
-    return 0;
-}
-
-//******************************************************************************
-//
-// ProcessCFWUContent - Process the content component firmware update command.
-//                      NOTE: this function is non reentrant - only to be called
-//                            from single thread. If this is not the case
-//                            for your implementation - extra care must be
-//                            made for thread safety.
-// Input Parameters
-//      FWUPDATE_CONTENT_COMMAND* pCommand - The command to process.
-//      FWUPDATE_CONTENT_RESPONSE* pResponse - The response to populate.
-//
-//******************************************************************************
-void ProcessCFWUContent(FWUPDATE_CONTENT_COMMAND* pCommand, 
-        FWUPDATE_CONTENT_RESPONSE* pResponse)
-{
-    UINT8 status = FIRMWARE_UPDATE_STATUS_SUCCESS;
-    UINT16 sequenceNumber = pCommand->sequenceNumber;
-    UINT8 componentId = s_currentOffer.activeComponentId;
-
-    if (pCommand->flags & FIRMWARE_UPDATE_FLAG_FIRST_BLOCK)
-    {
-        // FWU: Received first block flag, starting FWupdate.
-
-        if (ICompFwUpdateBspPrepare(componentId) == 0)
-        {
-            if (ICompFwUpdateBspWrite(pCommand->address, pCommand->pData, 
-                        pCommand->length, componentId) != 0)
-            {
-                status = FIRMWARE_UPDATE_STATUS_ERROR_WRITE;
-            }
-        }
-        else
-        {
-            status = FIRMWARE_UPDATE_STATUS_ERROR_PREPARE;
-        }
-
-    }
-    else if (pCommand->flags & FIRMWARE_UPDATE_FLAG_LAST_BLOCK)
-    {
-        if (ICompFwUpdateBspWrite(pCommand->address, pCommand->pData, 
-                    pCommand->length, componentId) == 0)
-        {
-            COMPONENT_REGISTRATION* pRegistration = s_pFirstComponentIFace;
-
-            MCU_STATUS getCrcOffsetResult = MCU_STATUS_DEFAULT_ERROR;
-            UINT32 crcOffset = 0;
-
-            // NOTE: it is assumed component registration has already been completed
-            //       before this function is called and that registration will not
-            //       change for the duration of the running image. If this is NOT
-            //       correct for your implementation - it is left up to the developer
-            //       to wrap the registration iteration below in a thread safe construct.
-            while (pRegistration)
-            {
-                if (pRegistration->componentId == componentId)
-                {
-                    // Found a matching componentId.
-                    // Each component image should have an embedded CRC in the 
-                    // downloaded image. Get the CRC offset for this particular component
-                    // image. 
-                    // Developer TODO- provide implementation of these helper functions
-                    //                 that have a priori knowledge of crc/image
-                    getCrcOffsetResult = pRegistration->interface.GetCrcOffset(&crcOffset);
-                    break;
-                }
-
-                pRegistration = pRegistration->pNext;
-            }
-
-            if (!MCU_SUCCESS(getCrcOffsetResult))
-            {
-                // Error retrieving crc offset
-                status = FIRMWARE_UPDATE_STATUS_ERROR_INVALID;
-            }
-            else if (getCrcOffsetResult != MCU_STATUS_CFU_CRC_CHECK_NOT_REQUIRED)
-            {
-                // CRC check required
-                UINT16 crc;
-                UINT16 calculatedCrc;
-
-                if (ICompFwUpdateBspCalcCRC(&calculatedCrc,  componentId) != 0)
-                {
-                    status = FIRMWARE_UPDATE_STATUS_ERROR_CRC;
-                }
-                else if (ICompFwUpdateBspRead(crcOffset, (UINT8*)&crc, sizeof(crc), componentId) != 0)
-                {
-                    status = FIRMWARE_UPDATE_STATUS_ERROR_CRC;
-                }
-                else if (crc != calculatedCrc)
-                {
-                    status = FIRMWARE_UPDATE_STATUS_ERROR_CRC;
-                }
-                else
-                {
-                    //Successfully validated CRC
-                    
-                    //Perform any other image verification here
-                    //  ex. Signatures, cert, encryption/decryption etc
-
-                    // Best practices require that this image be verified to have come 
-                    // from a non-rogue entity. To accomplish this, the image should
-                    // be authenticated by some sort of cryptographically safe mechanism.
-                    // (ex. certificate verification, pub/private key signing etc)
-                    // Developer TODO- provide implementation of this authentication 
-                    //                 implementation for their FW image.
-                    if (ICompFwUpdateBspAuthenticateFWImage() != 0)
-                    {
-                        status = FIRMWARE_UPDATE_STATUS_ERROR_SIGNATURE;
-                    }
-                }
-            }
-            else
-            {
-                // Skipping CRC check 
-
-                // Best practices require that this image be verified to have come 
-                // from a non-rogue entity. To accomplish this, the image should
-                // be authenticated by some sort of cryptologically safe mechanism.
-                // (ex. certificate verification, pub/private key signing etc)
-                // Developer TODO- provide implementation of this authentification 
-                //                 implementation for their FW image.
-                if (ICompFwUpdateBspAuthenticateFWImage() != 0)
-                {
-                    status = FIRMWARE_UPDATE_STATUS_ERROR_SIGNATURE;
-                }
-            }
-
-            if (status == FIRMWARE_UPDATE_STATUS_SUCCESS)
-            {
-                if (MCU_SUCCESS(pRegistration->
-                            interface.NotifySuccess(s_currentOffer.forceReset, 
-                                ICompFwUpdateBspRead, _ReadCompleteCallback)))
-                {
-                    // Final component specific step of image consumption has succeeded
-                    // We have successfully completed a FW Image write, 
-                    // For some components this maybe be the last step of image
-                    // update -> the next line can be commented out.
-                    // For components that employ two banks and do
-                    // ping pong updates - you may have to notify the 
-                    // CFU code that a bank swap is pending. This will ensure
-                    // that the CFU engine will not accept another image
-                    // until the swap occurs. 
-                    s_bankSwapPending = TRUE;
-                }
-                else
-                {
-                    // Final component specific step of image consumption has failed
-                    status = FIRMWARE_UPDATE_STATUS_ERROR_COMPLETE;
-                }
-            }
-        }
-        else
-        {
-            status = FIRMWARE_UPDATE_STATUS_ERROR_WRITE;
-        }
-    }
-    else
-    {
-        if (ICompFwUpdateBspWrite(pCommand->address, pCommand->pData, pCommand->length, componentId) != 0)
-        {
-            status = FIRMWARE_UPDATE_STATUS_ERROR_WRITE;
-        }
-    }
-
-    if (status != FIRMWARE_UPDATE_STATUS_SUCCESS)
-    {
-        s_currentOffer.updateInProgress = FALSE;
-    }
-
-    memset(pResponse, 0, sizeof(FWUPDATE_CONTENT_RESPONSE));
-    pResponse->sequenceNumber = sequenceNumber;
-    pResponse->status = status;
-}
-
-//******************************************************************************
-//
-// ProcessCFWUOffer - Process the offer component firmware update command.
-//                      NOTE: this function is non reentrant - only to be called
-//                            from single thread. If this is not the case
-//                            for your implementation - extra care must be
-//                            made for thread safety. 
-//
-// Input Parameters
-//      FWUPDATE_OFFER_COMMAND* pCommand - The command to process.
-//      FWUPDATE_OFFER_RESPONSE* pResponse - The response to populate.
-//
-//******************************************************************************
-void ProcessCFWUOffer(FWUPDATE_OFFER_COMMAND* pCommand, 
-                      FWUPDATE_OFFER_RESPONSE* pResponse)
-{
-
-    // A token is a user-software defined byte.  It's a signature
-    // that disambiguates one user-software conducting a CFU from
-    // another user-software programming conducting a CFU.  Elect
-    // a unique token byte in the user-software design.  The CFU
-    // implementation does not define tokens.
-    UINT8 token = pCommand->componentInfo.token;
-
-    UINT8 componentId = pCommand->componentInfo.componentId;
-
-    // The last offer isn't completely processed.
-    // When the offer that was last offered still remains pending
-    // completion, the state is FIRMWARE_UPDATE_OFFER_BUSY.
-    // If this condition is detected, return immediately.
-    if (s_currentOffer.updateInProgress)
-    {
-        memset(pResponse, 0, sizeof (FWUPDATE_OFFER_RESPONSE));
-
-        pResponse->status = FIRMWARE_UPDATE_OFFER_BUSY;
-        pResponse->rejectReasonCode = FIRMWARE_UPDATE_OFFER_BUSY;
-        pResponse->token = token;
-        return;
-    }
-
-    // Or, if intent is to retrieve the status of a special offer
-    // If this condition is detected, return immediately.
-    else if (componentId == CFU_SPECIAL_OFFER_CMD)
-    {
-        FWUPDATE_SPECIAL_OFFER_COMMAND* pSpecialCommand = 
-            (FWUPDATE_SPECIAL_OFFER_COMMAND*)pCommand;
-        if (pSpecialCommand->componentInfo.commandCode == CFU_SPECIAL_OFFER_GET_STATUS)
-        {
-            memset(pResponse, 0, sizeof (FWUPDATE_OFFER_RESPONSE));
-
-            pResponse->status = FIRMWARE_UPDATE_OFFER_COMMAND_READY;
-            pResponse->token = token;
-            return;
-        }
-    }
-
-    // Or, if the MCU is in progress of swapping Bank 0 for Bank 1 (or vice versa)
-    // so the offer is rejected 
-    // If this condition is detected, return immediately.
-    else if (s_bankSwapPending)
-    {
-        memset(pResponse, 0, sizeof (FWUPDATE_OFFER_RESPONSE));
-
-        pResponse->status = FIRMWARE_UPDATE_OFFER_REJECT;
-        pResponse->rejectReasonCode = FIRMWARE_UPDATE_OFFER_SWAP_PENDING;
-        pResponse->token = token;
-        return;
-    }
-
-    // Else, continue processing the offer by inspecting the registration list.  
-    //    Each offer will specify whether or not to:
-    //        A) force a MCU reset after processing the offer content
-    //        B) ignore the version of the MCU Component Firmware when
-    //           analyzing this offers version.
-    //
-    //    Unless there was overriding flags via "force" or "ignore"
-    //    Then the offer is accepted and this notifies the other
-    //    user software to move towards the action of submitting Content.
-    COMPONENT_REGISTRATION* pRegistration = s_pFirstComponentIFace;
-
-    // NOTE: it is assumed component registration has already been completed
-    //       before this function is called and that registration will not
-    //       change for the duration of the running image. If this is NOT
-    //       correct for your implementation - it is left up to the developer
-    //       to wrap the registration iteration below in a thread safe construct.
-    while (pRegistration)
-    {
-        if (pRegistration->componentId == componentId)
-        {
-            BOOL forceReset = pCommand->componentInfo.forceImmediateReset;
-            BOOL ignoreVersion = pCommand->componentInfo.forceIgnoreVersion;
-
-            // Found a matching componentId, present the offer to the handler
-            pRegistration->interface.ProcessOffer(pCommand, pResponse);
-
-            // This sample code shows how to send offer information
-            // that includes the request to ignore checking any version
-            // info. 
-            // If we're ignoring FWVersion check, and that was the reason 
-            // the offer was rejected, reverse the decision
-            // NOTE:  in released/final Firmware, this ability to accept
-            //        any version is usually disabled in FW (this is a TODO
-            //        for implementers of CFU)
-            if (ignoreVersion)
-            {
-                if ((pResponse->status == FIRMWARE_UPDATE_OFFER_REJECT) 
-                        && (pResponse->rejectReasonCode == FIRMWARE_OFFER_REJECT_OLD_FW))
-                {
-                    pResponse->status = FIRMWARE_UPDATE_OFFER_ACCEPT;
-                }
-            }
-
-            // This is the point detecting that the offer is accepted
-            // This implementation starts a timer to ensure the FW
-            // does not wait forever for the update process to complete.
-            if (pResponse->status == FIRMWARE_UPDATE_OFFER_ACCEPT)
-            {
-                BSP_Timer_Restart(s_updateTimer);
-                s_currentOffer.updateInProgress = TRUE;
-                s_currentOffer.forceReset = forceReset;
-                s_currentOffer.activeComponentId = componentId;
-            }
-
-            break;
-        }
-
-        pRegistration = pRegistration->pNext;
-    }
-}
-
-//******************************************************************************
-//
-// ProcessCFWUGetFWVersion - Process the get firmware version component firmware 
-// update command.
-//
-// Input Parameters
-//      GET_FWVERSION_RESPONSE* pResponse - The response to populate.
-//
-//******************************************************************************
-void ProcessCFWUGetFWVersion(GET_FWVERSION_RESPONSE* pResponse)
-{
-    //Received CFWU GetFwVersion
-
-    ASSERT(pResponse != NULL);
-
-    memset(pResponse, 0, sizeof(GET_FWVERSION_RESPONSE));
-
-    //CFU Protocol version
-    pResponse->header.fwUpdateRevision = CPFWU_REVISION;
-
-    COMPONENT_REGISTRATION* pRegistration = s_pFirstComponentIFace;
-
-    UINT8 componentCount = 0;
-
-    // Fill out the Version and Product Info (variable length)
-    pRegistration = s_pFirstComponentIFace;
-    UINT32* pVersion = (UINT32*)pResponse->versionAndProductInfoBlob;
-
-    // NOTE: it is assumed component registration has already been completed
-    //       before this function is called and that registration will not
-    //       change for the duration of the running image. If this is NOT
-    //       correct for your implementation - it is left up to the developer
-    //       to wrap the registration iteration below in a thread safe construct.
-    while (pRegistration)
-    {
-        // This gathers the version and product info
-        // of ALL the components that this FW has 
-        // registered for.
-        // Developer TODO - implement and register version and product 
-        //                  info gathering functions
-        pRegistration->interface.GetVersion(pVersion);
-        *pVersion++;
-        pRegistration->interface.GetProductInfo(pVersion);
-        *pVersion++;
-        pRegistration = pRegistration->pNext;
-        componentCount++;
-    }
-
-    pResponse->header.componentCount = componentCount;
-}
-
-//****************************************************************************
-//
-// IComponentFirmwareUpdateRegisterComponent - Register component interface
-//
-// Input Parameters
-//      COMPONENT_REGISTRATION* pRegistration.
-//
-//****************************************************************************
-void IComponentFirmwareUpdateRegisterComponent(COMPONENT_REGISTRATION* pRegistration)
-{
-    if (!pRegistration)
-    {
-        return;
-    }
-
-    // Because registration can happen from any thread
-    // - we will need to wrap the below in a thread safe construct
-    //   It is left up to implementation to provide such construct.
-    
-    // Developer TODO  -Implementation of thread safety is left to developer
-    //                  (example critical section calls below)
-    //  ENTER_CRITICAL_SECTION();
-    {
-        pRegistration->pNext = s_pFirstComponentIFace;
-        s_pFirstComponentIFace = pRegistration;
-    }
-    // EXIT_CRITICAL_SECTION();;
-}
-
+/*++
+    This file is part of Component Firmware Update (CFU), licensed under
+    the MIT License (MIT).
+
+    Copyright (c) Microsoft Corporation. All rights reserved.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+Module Name:
+
+    ComponentFwUpdate.c
+
+Abstract:
+
+    Implementation of the component firmware update protocol.
+
+Environment:
+
+    Firmware driver. 
+--*/
+//****************************************************************************
+//
+//                               INCLUDES
+//
+//****************************************************************************
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "coretypes.h"
+#include "ComponentFwUpdate.h"
+#include "ComponentFwUpdateConfig.h"
+#include "Crc16.h"
+#include "ICompFwUpdateBsp.h"
+#include "IComponentFirmwareUpdate.h"
+#include "FwVersion.h"
+#include "Sha256.h"
+#if CFU_STATIC_COMPONENTS
+#ifndef CFU_COMPONENT_TABLE_HEADER
+#error CFU_STATIC_COMPONENTS requires CFU_COMPONENT_TABLE_HEADER
+#endif
+#include CFU_COMPONENT_TABLE_HEADER
+#endif
+
+#define CPFWU_REVISION  (2u)
+
+//****************************************************************************
+//
+//                                  DEFINES
+//
+//****************************************************************************
+// Developer TODO  - Modify Timer functionality to meet your platform needs.
+//                   (or set CFU_BSP_TIMER and implement it in the BSP)
+#if !CFU_BSP_TIMER
+TIMER_ID BSP_Timer_Create ( void (* pTimerCallback)(void), UINT32 timeoutMs){return (TIMER_ID) 1;}
+void BSP_Timer_Stop(TIMER_ID timerId){}
+void BSP_Timer_Restart(TIMER_ID timerId){}
+#endif
+// 
+
+// Maximum time for a single image update to finish.
+//   if it takes longer than this - the CFU engine is reset.
+// Developer TODO  - set your own time out value
+#define MAX_FW_UPDATE_TIME_FAIL_SAFE_MS         (20 * 60 * 1000)
+
+// Asynchronous programming fills one write buffer while the other one is
+// being programmed. With write lists each half of the buffers is one list.
+#if CFU_ASYNC_WRITE
+#if !CFU_WRITE_COALESCING
+#error CFU_ASYNC_WRITE requires CFU_WRITE_COALESCING
+#endif
+#if CFU_WRITE_LIST
+#define CFU_WRITE_BUFFER_COUNT                  (2 * CFU_WRITE_LIST_PAGES)
+#else
+#define CFU_WRITE_BUFFER_COUNT                  (2)
+#endif
+#else
+#define CFU_WRITE_BUFFER_COUNT                  (1)
+#endif
+
+#if CFU_WRITE_LIST
+#if !CFU_ASYNC_WRITE
+#error CFU_WRITE_LIST requires CFU_ASYNC_WRITE
+#endif
+#if (CFU_WRITE_LIST_PAGES < 1) || (CFU_WRITE_LIST_PAGES > 255)
+#error CFU_WRITE_LIST_PAGES must be 1 to 255
+#endif
+#endif
+
+// Stack buffer used to hash a range of the staging area
+#define COMPARE_READ_CHUNK                      (64)
+
+// Each session needs its own read complete trampoline, see
+// s_readCompleteCallbacks.
+#if (CFU_MAX_SESSIONS < 1) || (CFU_MAX_SESSIONS > 4)
+#error CFU_MAX_SESSIONS must be between 1 and 4
+#endif
+
+// Encoding of the content of an update, chosen by the offer. Blocks of an
+// encoded payload are addressed within the encoded stream.
+#define PAYLOAD_ENCODING_NONE                   (0)
+#define PAYLOAD_ENCODING_DELTA                  (1)
+#define PAYLOAD_ENCODING_COMPRESSED             (2)
+#define CFU_ENCODED_PAYLOAD                     (CFU_DELTA_PAYLOAD || CFU_COMPRESSED_PAYLOAD)
+
+// Blocks past the cumulative acknowledgement are tracked in a UINT32
+#if CFU_CONTENT_WINDOW_MAX > 32
+#error CFU_CONTENT_WINDOW_MAX must be at most 32
+#endif
+
+// Received blocks are numbered with a UINT16
+#if CFU_UNORDERED_CONTENT && (CFU_RECEIVE_BITMAP_BYTES > 8192)
+#error CFU_RECEIVE_BITMAP_BYTES must be at most 8192
+#endif
+
+// Time the BSP and component calls of each phase of an update. TIMING_START
+// declares the start tick.
+#if CFU_TIMING_STATS
+#define TIMING_START(start)                     UINT32 start = ICompFwUpdateBspGetTicks()
+#define TIMING_STOP(pSession, phase, start)     _RecordTiming((pSession), (phase), (start))
+#else
+#define TIMING_START(start)
+#define TIMING_STOP(pSession, phase, start)
+#endif
+
+// Components registered at compile time are listed by CFU_COMPONENT_TABLE(X),
+// which invokes
+//   X(componentId, prefix, flags, writePageSize, eraseSectorSize,
+//     inactivityTimeoutMs, digestLength, pRegions, regionCount, pStorage)
+// for each of them. prefix##GetVersion, prefix##GetProductInfo,
+// prefix##ProcessOffer, prefix##GetCrcOffset and prefix##NotifySuccess are
+// its handlers, called directly from a switch on the componentId.
+#if CFU_STATIC_COMPONENTS
+#define STATIC_COMPONENT_ENUM(id, prefix, ...)          STATIC_COMPONENT_##prefix,
+#define STATIC_COMPONENT_INDEX(id, prefix, ...)         case (id): return STATIC_COMPONENT_##prefix + 1;
+#define STATIC_COMPONENT_REGISTRATION(id, prefix, flags, pageSize, sectorSize, timeoutMs, digestLength, pRegions, regionCount, pStorage) \
+    { NULL, { NULL, NULL, NULL, NULL, NULL }, (id), (flags), (pageSize), (sectorSize), (timeoutMs), (digestLength), (pRegions), (regionCount), (pStorage) },
+#define STATIC_GET_VERSION(id, prefix, ...)             case (id): return prefix##GetVersion(pVersion);
+#define STATIC_GET_PRODUCT_INFO(id, prefix, ...)        case (id): return prefix##GetProductInfo(pProductInfo);
+#define STATIC_PROCESS_OFFER(id, prefix, ...)           case (id): return prefix##ProcessOffer(pCommand, pResponse);
+#define STATIC_GET_CRC_OFFSET(id, prefix, ...)          case (id): return prefix##GetCrcOffset(pOffset);
+#define STATIC_NOTIFY_SUCCESS(id, prefix, ...)          case (id): return prefix##NotifySuccess(forceReset, readHandler, readCompleteHandler);
+
+enum { CFU_COMPONENT_TABLE(STATIC_COMPONENT_ENUM) STATIC_COMPONENT_COUNT };
+
+#define COMPONENT_COUNT                         (STATIC_COMPONENT_COUNT)
+#define COMPONENT_CAPACITY                      (STATIC_COMPONENT_COUNT)
+#define COMPONENT_AT(index)                     (&s_staticComponents[index])
+#else
+#define COMPONENT_COUNT                         (s_componentCount)
+#define COMPONENT_CAPACITY                      (MAX_REGISTERED_COMPONENTS)
+#define COMPONENT_AT(index)                     (s_pComponents[index])
+#endif
+
+#if CFU_COMPRESSED_PAYLOAD && \
+    ((CFU_COMPRESS_WINDOW & (CFU_COMPRESS_WINDOW - 1)) || (CFU_COMPRESS_WINDOW > 32768))
+#error CFU_COMPRESS_WINDOW must be a power of two, at most 32768
+#endif
+
+//****************************************************************************
+//
+//                                  TYPEDEFS
+//
+//****************************************************************************
+#if CFU_TIMING_STATS
+// Calls timed in one phase of an update, in ICompFwUpdateBspGetTicks ticks
+typedef struct
+{
+    UINT32                  count;
+    UINT32                  minTicks;
+    UINT32                  maxTicks;
+    UINT64                  totalTicks;
+} CFU_TIMING_STAT;
+#endif
+
+typedef struct
+{
+    UINT8                   activeComponentId;
+    const COMPONENT_REGISTRATION* pActiveComponent;
+    // Storage of the active component
+    const COMPONENT_STORAGE* pStorage;
+    BOOL                    forceReset;
+    BOOL                    updateInProgress;
+#if CFU_INACTIVITY_TIMEOUT_MS
+    // Time since the offer or the last content command, counted by the
+    // inactivity timer.
+    UINT32                  idleMs;
+#endif
+#if CFU_CONTENT_WINDOW_MAX
+    // Negotiated content window, 0 for stop-and-wait. All blocks up to
+    // ackSequenceNumber have been received; bit n of selectiveAckMask is set
+    // when block ackSequenceNumber + 1 + n has been received.
+    UINT8                   contentWindow;
+    BOOL                    windowStarted;
+    BOOL                    lastBlockReceived;
+    UINT16                  ackSequenceNumber;
+    UINT16                  lastSequenceNumber;
+    UINT32                  selectiveAckMask;
+#endif
+#if CFU_TIMING_STATS
+    // Timing of each CFU_TIMING_PHASE_xxx since the last accepted offer
+    CFU_TIMING_STAT         timing[CFU_TIMING_PHASE_COUNT];
+#endif
+#if CFU_UNORDERED_CONTENT
+    // Out of order content. Block n is at receiveBase + n * receiveBlockLength
+    // and bit n of receivedBlocks is set once it has been written.
+    // lastBlockIndex is MAX_UINT16 until the last block has been received.
+    BOOL                    unorderedContent;
+    BOOL                    unorderedStarted;
+    UINT32                  receiveBase;
+    UINT8                   receiveBlockLength;
+    UINT16                  receivedCount;
+    UINT16                  highestBlockIndex;
+    UINT16                  lastBlockIndex;
+    UINT8                   receivedBlocks[CFU_RECEIVE_BITMAP_BYTES];
+#endif
+#if CFU_BACKGROUND_VERIFY
+    // Background verification. verifyPending is set from the last block
+    // until FirmwareUpdateBackgroundTask has verified the image, whose
+    // FIRMWARE_UPDATE_STATUS_xxx is then kept in verifyStatus until the next
+    // offer. notifyPending is set while a NOTIFY_ON_READY offer waits for
+    // the result.
+    BOOL                    backgroundVerify;
+    BOOL                    verifyPending;
+    BOOL                    verifyDone;
+    UINT8                   verifyStatus;
+    BOOL                    notifyPending;
+    UINT8                   notifyToken;
+#endif
+#if CFU_STREAMING_CRC
+    // Running CRC of the image, valid while blocks arrive contiguously
+    BOOL                    crcStreamValid;
+    UINT16                  runningCrc;
+    UINT32                  nextCrcAddress;
+    UINT32                  crcOffset;
+    // Embedded CRC bytes captured from the content stream
+    UINT8                   embeddedCrc[sizeof(UINT16)];
+    UINT8                   embeddedCrcMask;
+#endif
+#if CFU_STREAMING_DIGEST
+    // SHA-256 of the image up to digestEndAddress, valid while blocks
+    // arrive contiguously
+    BOOL                    digestStreamValid;
+    UINT32                  nextDigestAddress;
+    UINT32                  digestEndAddress;
+    SHA256_CONTEXT          digest;
+#endif
+#if CFU_WRITE_COALESCING
+    // Contiguous data not yet handed to ICompFwUpdateBspWritePage. It never
+    // crosses a page boundary of the active component.
+    UINT32                  writeBuffer[CFU_WRITE_BUFFER_COUNT][CFU_WRITE_BUFFER_SIZE / sizeof(UINT32)];
+    UINT32                  writeBufferAddress;
+    UINT16                  writeBufferLength;
+    UINT16                  writeBufferSequence;
+    UINT8                   writeBufferIndex;
+#endif
+#if CFU_ASYNC_WRITE
+    // State of the page (or list) being programmed from the other write
+    // buffer. Updated from the BSP write completion callback.
+    volatile BOOL           asyncWriteInFlight;
+    volatile UINT32         asyncWriteResult;
+    UINT16                  asyncWriteSequence;
+#endif
+#if CFU_WRITE_LIST
+    // Pages of the list being filled (writeListHalf) and of the list being
+    // programmed (the other half). Full pages are queued in the list until
+    // it is full or the writes are completed.
+    CFU_WRITE_DESCRIPTOR    writeList[2][CFU_WRITE_LIST_PAGES];
+    UINT16                  writeListSequence;
+    UINT8                   writeListCount;
+    UINT8                   writeListHalf;
+#endif
+#if CFU_LAZY_ERASE
+    // One bit per erase sector of the active component, set once the
+    // sector has been erased for the current image.
+    UINT8                   erasedSectors[CFU_ERASE_BITMAP_BYTES];
+    UINT8                   eraseSectorShift;
+#endif
+#if CFU_RESUMABLE_TRANSFER
+    // Version of the accepted offer and the last stored resume point.
+    // resumePending is set when the offer matched the stored resume point
+    // and no content has arrived yet.
+    UINT32                  offerVersion;
+    CFU_CHECKPOINT          checkpoint;
+    BOOL                    resumePending;
+#endif
+#if CFU_ENCODED_PAYLOAD
+    // PAYLOAD_ENCODING_xxx of the accepted offer. streamOffset counts the
+    // encoded bytes received and outputAddress is where the next image byte
+    // goes.
+    UINT8                   payloadEncoding;
+    UINT32                  streamOffset;
+    UINT32                  outputAddress;
+#endif
+#if CFU_DELTA_PAYLOAD
+    // Delta decoder. deltaOp is the operation being decoded, 0 between
+    // operations.
+    UINT32                  deltaSource;
+    UINT16                  deltaRemaining;
+    UINT8                   deltaOp;
+    UINT8                   deltaArgSize;
+    UINT8                   deltaArgLength;
+    UINT8                   deltaArgs[2 * sizeof(UINT32)];
+#endif
+#if CFU_COMPRESSED_PAYLOAD
+    // Decompressor. Between tokens both compressLiterals and
+    // compressMatchLength are 0; compressArgs collects the distance of a
+    // match. The history holds the last CFU_COMPRESS_WINDOW output bytes,
+    // indexed by outputAddress.
+    UINT8                   compressLiterals;
+    UINT8                   compressMatchLength;
+    UINT8                   compressArgLength;
+    UINT8                   compressArgs[sizeof(UINT16)];
+    UINT8                   compressHistory[CFU_COMPRESS_WINDOW];
+#endif
+} CURRENT_OFFER_INFO;
+
+//****************************************************************************
+//
+//                              STATIC VARIABLES
+//
+//****************************************************************************
+// One update session per concurrently updated component. A session is
+// chosen by the host with the sessionId of the offer and the session bits
+// of each content command's flags. Hosts that do not know about sessions
+// always use session 0.
+static CURRENT_OFFER_INFO       s_sessions[CFU_MAX_SESSIONS];
+// Registered components in registration order, plus either a table indexed
+// by componentId holding (position in s_pComponents + 1), 0 meaning not
+// registered, or the positions sorted by componentId for a binary search,
+// see CFU_COMPONENT_INDEX_TABLE. With CFU_STATIC_COMPONENTS they come from
+// CFU_COMPONENT_TABLE instead, in flash.
+#if CFU_STATIC_COMPONENTS
+static const COMPONENT_REGISTRATION s_staticComponents[STATIC_COMPONENT_COUNT] =
+{
+    CFU_COMPONENT_TABLE(STATIC_COMPONENT_REGISTRATION)
+};
+#else
+static COMPONENT_REGISTRATION*  s_pComponents[MAX_REGISTERED_COMPONENTS];
+#if CFU_COMPONENT_INDEX_TABLE
+static UINT8                    s_componentIndex[MAX_UINT8 + 1];
+#else
+static UINT8                    s_componentOrder[MAX_REGISTERED_COMPONENTS];
+#endif
+static UINT8                    s_componentCount = 0;
+#endif
+static TIMER_ID                 s_updateTimer = 0; //BSP Modify initial value 
+                                                   // to your platform needs
+#if CFU_INACTIVITY_TIMEOUT_MS
+static TIMER_ID                 s_inactivityTimer = 0;
+#endif
+static BOOL                     s_bankSwapPending = FALSE;
+// Page the next GET_FWVERSION reports, see ProcessCFWUGetFWVersion
+static UINT8                    s_fwVersionPage = 0;
+// Storage of components that do not register their own
+static const COMPONENT_STORAGE  s_bspStorage =
+{
+    ICompFwUpdateBspPrepare,
+#if CFU_LAZY_ERASE
+    ICompFwUpdateBspEraseSector,
+#else
+    NULL,
+#endif
+    ICompFwUpdateBspWrite,
+#if CFU_WRITE_COALESCING
+    ICompFwUpdateBspWritePage,
+#else
+    NULL,
+#endif
+#if CFU_ASYNC_WRITE
+    ICompFwUpdateBspWritePageAsync,
+#else
+    NULL,
+#endif
+#if CFU_WRITE_LIST
+    ICompFwUpdateBspWriteList,
+#else
+    NULL,
+#endif
+    ICompFwUpdateBspRead,
+#if CFU_DELTA_PAYLOAD
+    ICompFwUpdateBspReadCurrent,
+#else
+    NULL,
+#endif
+    ICompFwUpdateBspCalcCRC,
+    NULL,
+    NULL,
+};
+#if CFU_OFFER_LIST
+// Offers received since OFFER_INFO_START_OFFER_LIST, in arrival order
+static BOOL                     s_offerListActive = FALSE;
+static UINT8                    s_offerListCount = 0;
+static FWUPDATE_OFFER_COMMAND   s_offerList[CFU_OFFER_LIST_MAX];
+#endif
+#if CFU_UNORDERED_CONTENT && CFU_RANGE_COMPARE
+// Components, by componentId, with ranges reported as matching since they
+// were last prepared.
+static UINT8                    s_rangesMatched[(MAX_UINT8 + 1) / 8];
+#endif
+#if CFU_VERSION_CACHE
+// Version and product info of each component, in s_pComponents order.
+static UINT32                   s_versionCache[COMPONENT_CAPACITY][2];
+#endif
+//****************************************************************************
+//
+//                          STATIC FUNCTION PROTOTYPES
+//
+//****************************************************************************
+static void _ReadCompleteCallback(UINT8 sessionId);
+static void _ReadCompleteCallback0(void);
+#if CFU_MAX_SESSIONS > 1
+static void _ReadCompleteCallback1(void);
+#endif
+#if CFU_MAX_SESSIONS > 2
+static void _ReadCompleteCallback2(void);
+#endif
+#if CFU_MAX_SESSIONS > 3
+static void _ReadCompleteCallback3(void);
+#endif
+static CURRENT_OFFER_INFO* _FindSession(UINT8 componentId);
+static BOOL _IsUpdateInProgress(void);
+#if CFU_VERSION_CACHE
+static void _RefreshVersionCache(UINT8 index);
+#endif
+static void _UpdateTimerCallback(void);
+#if CFU_INACTIVITY_TIMEOUT_MS
+static void _InactivityTimerCallback(void);
+#endif
+static void _AbortSessions(UINT8 componentId);
+#if CFU_TIMING_STATS
+static void _ResetTiming(CURRENT_OFFER_INFO* pSession);
+static void _RecordTiming(CURRENT_OFFER_INFO* pSession, UINT8 phase, UINT32 start);
+#endif
+static UINT8 _ComponentIndex(UINT8 componentId);
+static const COMPONENT_REGISTRATION* _FindComponent(UINT8 componentId);
+static const COMPONENT_STORAGE* _FindStorage(const COMPONENT_REGISTRATION* pRegistration);
+static MCU_STATUS _ComponentGetVersion(const COMPONENT_REGISTRATION* pRegistration, UINT32* pVersion);
+static MCU_STATUS _ComponentGetProductInfo(const COMPONENT_REGISTRATION* pRegistration, UINT32* pProductInfo);
+static MCU_STATUS _ComponentProcessOffer(const COMPONENT_REGISTRATION* pRegistration, FWUPDATE_OFFER_COMMAND* pCommand, FWUPDATE_OFFER_RESPONSE* pResponse);
+static MCU_STATUS _ComponentGetCrcOffset(const COMPONENT_REGISTRATION* pRegistration, UINT32* pOffset);
+static MCU_STATUS _ComponentNotifySuccess(const COMPONENT_REGISTRATION* pRegistration, BOOL forceReset, READ_FIRMWARE_FUNC readHandler, READ_COMPLETED_FUNC readCompleteHandler);
+#if CFU_REGION_CHECK || CFU_DELTA_PAYLOAD
+static BOOL _IsWritableRange(const COMPONENT_REGISTRATION* pRegistration, UINT32 address, UINT32 length);
+#endif
+#if CFU_REGION_CHECK
+static BOOL _IsWritableBlock(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand);
+#endif
+#if CFU_STREAMING_CRC
+static void _StartStreamingCrc(CURRENT_OFFER_INFO* pSession, UINT32 address);
+static void _UpdateStreamingCrc(CURRENT_OFFER_INFO* pSession, UINT32 address, UINT8* pData, UINT8 length);
+#endif
+#if CFU_STREAMING_DIGEST
+static void _StartStreamingDigest(CURRENT_OFFER_INFO* pSession, UINT32 address);
+static void _UpdateStreamingDigest(CURRENT_OFFER_INFO* pSession, UINT32 address, UINT8* pData, UINT8 length);
+#endif
+static INT32 _AuthenticateImage(CURRENT_OFFER_INFO* pSession);
+#if CFU_LAZY_ERASE
+static void _StartLazyErase(CURRENT_OFFER_INFO* pSession);
+static UINT32 _EraseSectors(CURRENT_OFFER_INFO* pSession, UINT32 address, UINT32 length);
+#endif
+#if CFU_RANGE_COMPARE
+static UINT32 _HashRange(UINT32 address, UINT32 length, UINT8 componentId, UINT8* pDigest);
+static UINT32 _MatchRanges(const COMPONENT_REGISTRATION* pRegistration, UINT16 firstRange, UINT8 rangeShift, UINT8 rangeCount, const UINT8* pHashes);
+static void _CompareRanges(FWUPDATE_COMPARE_OFFER_COMMAND* pCommand, FWUPDATE_COMPARE_OFFER_RESPONSE* pResponse);
+static void _CompareContent(FWUPDATE_CONTENT_COMMAND* pCommand, UINT8 status, FWUPDATE_CONTENT_RESPONSE* pResponse);
+#endif
+#if CFU_CONTENT_WINDOW_MAX || CFU_RESUMABLE_TRANSFER || CFU_UNORDERED_CONTENT
+static BOOL _CoalescesWrites(const COMPONENT_REGISTRATION* pRegistration);
+#endif
+#if CFU_WRITE_COALESCING
+static UINT32 _CoalesceBlock(CURRENT_OFFER_INFO* pSession, UINT32 address, UINT8* pData, UINT8 length, UINT16* pSequenceNumber);
+#endif
+static UINT32 _FlushWriteBuffer(CURRENT_OFFER_INFO* pSession, UINT16* pSequenceNumber);
+#if CFU_ASYNC_WRITE
+static void _AsyncWriteCompleteCallback(UINT8 componentId, UINT32 result);
+static UINT32 _CheckAsyncWrite(CURRENT_OFFER_INFO* pSession, BOOL wait, UINT16* pSequenceNumber);
+#endif
+#if CFU_WRITE_LIST
+static UINT32 _QueueWritePage(CURRENT_OFFER_INFO* pSession, UINT8* pBuffer, UINT16 length, UINT16* pSequenceNumber);
+static UINT32 _StartWriteList(CURRENT_OFFER_INFO* pSession, UINT16* pSequenceNumber);
+static void _ResetWriteList(CURRENT_OFFER_INFO* pSession);
+#endif
+static UINT32 _CompleteWrites(CURRENT_OFFER_INFO* pSession, UINT16* pSequenceNumber);
+static UINT32 _WriteData(CURRENT_OFFER_INFO* pSession, UINT32 address, UINT8* pData, UINT8 length, UINT16* pSequenceNumber);
+static UINT32 _WriteBlock(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand, UINT16* pSequenceNumber);
+#if CFU_DELTA_PAYLOAD
+static UINT32 _CopyFromCurrentImage(CURRENT_OFFER_INFO* pSession, UINT32 length, UINT16* pSequenceNumber);
+static UINT32 _ApplyDelta(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand, UINT16* pSequenceNumber);
+#endif
+#if CFU_COMPRESSED_PAYLOAD
+static UINT32 _WriteDecompressed(CURRENT_OFFER_INFO* pSession, UINT8* pData, UINT8 length, UINT16* pSequenceNumber);
+static UINT32 _CopyMatch(CURRENT_OFFER_INFO* pSession, UINT16 distance, UINT8 length, UINT16* pSequenceNumber);
+static UINT32 _Decompress(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand, UINT16* pSequenceNumber);
+#endif
+static UINT8 _VerifyImageCrc(CURRENT_OFFER_INFO* pSession, UINT32 crcOffset, UINT8 componentId);
+static UINT8 _StartImage(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand, UINT16* pSequenceNumber);
+static UINT8 _FinishImage(CURRENT_OFFER_INFO* pSession, UINT16* pSequenceNumber);
+#if CFU_BACKGROUND_VERIFY
+static void _EndVerification(CURRENT_OFFER_INFO* pSession, UINT8 status);
+static void _NotifyOnReady(FWUPDATE_NOTIFY_OFFER_COMMAND* pCommand, FWUPDATE_NOTIFY_OFFER_RESPONSE* pResponse);
+#endif
+#if CFU_OFFER_LIST
+static void _EvaluateOfferList(void);
+static void _ProcessOfferInfo(FWUPDATE_OFFER_INFO_ONLY_COMMAND* pCommand, FWUPDATE_OFFER_RESPONSE* pResponse);
+#endif
+#if CFU_RESUMABLE_TRANSFER
+static BOOL _LoadCheckpoint(CFU_CHECKPOINT* pCheckpoint, UINT8 componentId, UINT32 version);
+static UINT32 _ClearCheckpoint(CURRENT_OFFER_INFO* pSession);
+static UINT32 _UpdateCheckpoint(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand, UINT16* pSequenceNumber);
+static UINT32 _ResumeImage(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand);
+static void _GetResumePoint(FWUPDATE_RESUME_OFFER_COMMAND* pCommand, FWUPDATE_RESUME_OFFER_RESPONSE* pResponse);
+#endif
+#if CFU_CONTENT_WINDOW_MAX
+static UINT8 _ProcessWindowedContent(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand, UINT16* pSequenceNumber);
+#endif
+#if CFU_UNORDERED_CONTENT
+static UINT8 _ProcessUnorderedContent(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand, UINT16* pSequenceNumber);
+#endif
+static void _BuildContentResponse(CURRENT_OFFER_INFO* pSession, UINT16 sequenceNumber, UINT8 status, FWUPDATE_CONTENT_RESPONSE* pResponse);
+static void _ProcessContent(FWUPDATE_CONTENT_COMMAND* pCommand, UINT8 status, FWUPDATE_CONTENT_RESPONSE* pResponse);
+//****************************************************************************
+//
+//                              STATIC CONSTANTS
+//
+//****************************************************************************
+// READ_COMPLETED_FUNC takes no arguments, so each session gets its own.
+static const READ_COMPLETED_FUNC s_readCompleteCallbacks[CFU_MAX_SESSIONS] =
+{
+    _ReadCompleteCallback0,
+#if CFU_MAX_SESSIONS > 1
+    _ReadCompleteCallback1,
+#endif
+#if CFU_MAX_SESSIONS > 2
+    _ReadCompleteCallback2,
+#endif
+#if CFU_MAX_SESSIONS > 3
+    _ReadCompleteCallback3,
+#endif
+};
+
+//****************************************************************************
+//
+//                              GLOBAL VARIABLES
+//
+//****************************************************************************
+
+//****************************************************************************
+//
+//                              FUNCTION CODE
+//
+//****************************************************************************
+
+//****************************************************************************
+//
+// _ReadCompleteCallback - Callback when component is done with image.
+//
+//****************************************************************************
+static void _ReadCompleteCallback(UINT8 sessionId)
+{
+    // Update of image has completed successfully. 
+    s_sessions[sessionId].updateInProgress = FALSE;
+}
+
+static void _ReadCompleteCallback0(void)
+{
+    _ReadCompleteCallback(0);
+}
+
+#if CFU_MAX_SESSIONS > 1
+static void _ReadCompleteCallback1(void)
+{
+    _ReadCompleteCallback(1);
+}
+#endif
+
+#if CFU_MAX_SESSIONS > 2
+static void _ReadCompleteCallback2(void)
+{
+    _ReadCompleteCallback(2);
+}
+#endif
+
+#if CFU_MAX_SESSIONS > 3
+static void _ReadCompleteCallback3(void)
+{
+    _ReadCompleteCallback(3);
+}
+#endif
+
+static void _UpdateTimerCallback(void)
+{
+    // Note: Typically you should wrap these timer callbacks
+    //       in a thread safe construct (Critical section etc).
+    //       Some implementations have timer task as highest
+    //       priority which would mitigate the requirement for this
+    //       example.
+    
+    // Developer TODO  -Implementation of thread safety is left to developer
+    //                  (example critical section calls below)
+    //  ENTER_CRITICAL_SECTION();
+    UINT8 sessionId;
+
+    // The fail safe timer is shared by all sessions, it resets all of them
+    for (sessionId = 0; sessionId < CFU_MAX_SESSIONS; sessionId++)
+    {
+        s_sessions[sessionId].updateInProgress = FALSE;
+    }
+    BSP_Timer_Stop(s_updateTimer);
+    //  EXIT_CRITICAL_SECTION();
+}
+
+#if CFU_INACTIVITY_TIMEOUT_MS
+//****************************************************************************
+//
+// _InactivityTimerCallback - Runs every CFU_INACTIVITY_TICK_MS while an
+//      update is in progress and ends the sessions whose host has not sent
+//      anything for the inactivity timeout of their component.
+//
+//****************************************************************************
+static void _InactivityTimerCallback(void)
+{
+    // Developer TODO  - Same thread safety considerations as 
+    //                   _UpdateTimerCallback
+    UINT8 sessionId;
+    BOOL active = FALSE;
+
+    for (sessionId = 0; sessionId < CFU_MAX_SESSIONS; sessionId++)
+    {
+        CURRENT_OFFER_INFO* pSession = &s_sessions[sessionId];
+        UINT32 timeoutMs;
+
+        if (!pSession->updateInProgress)
+        {
+            continue;
+        }
+
+#if CFU_BACKGROUND_VERIFY
+        // The host has sent everything and waits for the device
+        if (pSession->verifyPending)
+        {
+            active = TRUE;
+            continue;
+        }
+
+#endif
+        timeoutMs = pSession->pActiveComponent->inactivityTimeoutMs;
+
+        if (timeoutMs == 0)
+        {
+            timeoutMs = CFU_INACTIVITY_TIMEOUT_MS;
+        }
+
+        pSession->idleMs += CFU_INACTIVITY_TICK_MS;
+
+        if (pSession->idleMs >= timeoutMs)
+        {
+            pSession->updateInProgress = FALSE;
+        }
+        else
+        {
+            active = TRUE;
+        }
+    }
+
+    if (active)
+    {
+        BSP_Timer_Restart(s_inactivityTimer);
+    }
+    else
+    {
+        BSP_Timer_Stop(s_inactivityTimer);
+    }
+}
+#endif
+
+//****************************************************************************
+//
+// _AbortSessions - End the update sessions of a component, or all of them.
+//                  A stored resume point is kept.
+//
+// Input Parameters
+//      UINT8 componentId - The component, or CFU_SPECIAL_OFFER_ABORT_ALL.
+//
+//****************************************************************************
+static void _AbortSessions(UINT8 componentId)
+{
+    UINT8 sessionId;
+
+    for (sessionId = 0; sessionId < CFU_MAX_SESSIONS; sessionId++)
+    {
+        CURRENT_OFFER_INFO* pSession = &s_sessions[sessionId];
+
+        if ((componentId == CFU_SPECIAL_OFFER_ABORT_ALL) ||
+            (pSession->activeComponentId == componentId))
+        {
+            pSession->updateInProgress = FALSE;
+#if CFU_BACKGROUND_VERIFY
+            if (pSession->verifyPending)
+            {
+                _EndVerification(pSession, FIRMWARE_UPDATE_STATUS_ERROR_NO_OFFER);
+            }
+#endif
+        }
+    }
+}
+
+//****************************************************************************
+//
+// _ComponentIndex - Look up the position of a component in registration
+//                   order.
+//
+// Input Parameters
+//      UINT8 componentId - The component to look up.
+//
+// Return
+//      The position plus 1, or 0 if the component is not registered.
+//
+//****************************************************************************
+static UINT8 _ComponentIndex(UINT8 componentId)
+{
+#if CFU_STATIC_COMPONENTS
+    switch (componentId)
+    {
+        CFU_COMPONENT_TABLE(STATIC_COMPONENT_INDEX)
+    }
+
+    return 0;
+#elif CFU_COMPONENT_INDEX_TABLE
+    return s_componentIndex[componentId];
+#else
+    UINT8 low = 0;
+    UINT8 high = s_componentCount;
+
+    while (low < high)
+    {
+        UINT8 middle = (UINT8)((low + high) / 2);
+        UINT8 position = s_componentOrder[middle];
+        UINT8 id = s_pComponents[position]->componentId;
+
+        if (id == componentId)
+        {
+            return (UINT8)(position + 1);
+        }
+
+        if (id < componentId)
+        {
+            low = (UINT8)(middle + 1);
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return 0;
+#endif
+}
+
+//****************************************************************************
+//
+// _FindComponent - Look up the registration for a componentId.
+//
+// Input Parameters
+//      UINT8 componentId - The component to look up.
+//
+// Return
+//      The matching registration or NULL if none is registered.
+//
+//****************************************************************************
+static const COMPONENT_REGISTRATION* _FindComponent(UINT8 componentId)
+{
+    UINT8 index = _ComponentIndex(componentId);
+
+    if (index == 0)
+    {
+        return NULL;
+    }
+
+    return COMPONENT_AT(index - 1);
+}
+
+//****************************************************************************
+//
+// _FindStorage - Look up the storage of a component's staging area.
+//
+// Input Parameters
+//      const COMPONENT_REGISTRATION* pRegistration - The component, or NULL.
+//
+// Return
+//      The storage the component registered, or the ICompFwUpdateBspXxx
+//      functions.
+//
+//****************************************************************************
+static const COMPONENT_STORAGE* _FindStorage(const COMPONENT_REGISTRATION* pRegistration)
+{
+    if (pRegistration && pRegistration->pStorage)
+    {
+        return pRegistration->pStorage;
+    }
+
+    return &s_bspStorage;
+}
+
+//****************************************************************************
+//
+// _ComponentGetVersion, _ComponentGetProductInfo, _ComponentProcessOffer,
+// _ComponentGetCrcOffset, _ComponentNotifySuccess - Call a handler of a
+//      component: through its ICOMPONENT_INTERFACE, or directly for
+//      components of CFU_COMPONENT_TABLE, so that a handler can be inlined
+//      and those of a single component need no lookup at all.
+//
+// Input Parameters
+//      const COMPONENT_REGISTRATION* pRegistration - The component.
+//      The parameters of the handler.
+//
+// Return
+//      The MCU_STATUS of the handler.
+//
+//****************************************************************************
+static MCU_STATUS _ComponentGetVersion(const COMPONENT_REGISTRATION* pRegistration, UINT32* pVersion)
+{
+#if CFU_STATIC_COMPONENTS
+    switch (pRegistration->componentId)
+    {
+        CFU_COMPONENT_TABLE(STATIC_GET_VERSION)
+    }
+
+    return MCU_STATUS_DEFAULT_ERROR;
+#else
+    return pRegistration->interface.GetVersion(pVersion);
+#endif
+}
+
+static MCU_STATUS _ComponentGetProductInfo(const COMPONENT_REGISTRATION* pRegistration, UINT32* pProductInfo)
+{
+#if CFU_STATIC_COMPONENTS
+    switch (pRegistration->componentId)
+    {
+        CFU_COMPONENT_TABLE(STATIC_GET_PRODUCT_INFO)
+    }
+
+    return MCU_STATUS_DEFAULT_ERROR;
+#else
+    return pRegistration->interface.GetProductInfo(pProductInfo);
+#endif
+}
+
+static MCU_STATUS _ComponentProcessOffer(const COMPONENT_REGISTRATION* pRegistration, FWUPDATE_OFFER_COMMAND* pCommand, FWUPDATE_OFFER_RESPONSE* pResponse)
+{
+#if CFU_STATIC_COMPONENTS
+    switch (pRegistration->componentId)
+    {
+        CFU_COMPONENT_TABLE(STATIC_PROCESS_OFFER)
+    }
+
+    return MCU_STATUS_DEFAULT_ERROR;
+#else
+    return pRegistration->interface.ProcessOffer(pCommand, pResponse);
+#endif
+}
+
+static MCU_STATUS _ComponentGetCrcOffset(const COMPONENT_REGISTRATION* pRegistration, UINT32* pOffset)
+{
+#if CFU_STATIC_COMPONENTS
+    switch (pRegistration->componentId)
+    {
+        CFU_COMPONENT_TABLE(STATIC_GET_CRC_OFFSET)
+    }
+
+    return MCU_STATUS_DEFAULT_ERROR;
+#else
+    return pRegistration->interface.GetCrcOffset(pOffset);
+#endif
+}
+
+static MCU_STATUS _ComponentNotifySuccess(const COMPONENT_REGISTRATION* pRegistration, BOOL forceReset, READ_FIRMWARE_FUNC readHandler, READ_COMPLETED_FUNC readCompleteHandler)
+{
+#if CFU_STATIC_COMPONENTS
+    switch (pRegistration->componentId)
+    {
+        CFU_COMPONENT_TABLE(STATIC_NOTIFY_SUCCESS)
+    }
+
+    return MCU_STATUS_DEFAULT_ERROR;
+#else
+    return pRegistration->interface.NotifySuccess(forceReset, readHandler, readCompleteHandler);
+#endif
+}
+
+//****************************************************************************
+//
+// _FindSession - Find the session in progress for a componentId.
+//
+// Input Parameters
+//      UINT8 componentId - The component to look up.
+//
+// Return
+//      The session updating the component or NULL if there is none.
+//
+//****************************************************************************
+static CURRENT_OFFER_INFO* _FindSession(UINT8 componentId)
+{
+    UINT8 sessionId;
+
+    for (sessionId = 0; sessionId < CFU_MAX_SESSIONS; sessionId++)
+    {
+        if (s_sessions[sessionId].updateInProgress &&
+            (s_sessions[sessionId].activeComponentId == componentId))
+        {
+            return &s_sessions[sessionId];
+        }
+    }
+
+    return NULL;
+}
+
+//****************************************************************************
+//
+// _IsUpdateInProgress - Check whether any session has an update in progress.
+//
+// Return
+//      TRUE if a session is updating a component.
+//
+//****************************************************************************
+static BOOL _IsUpdateInProgress(void)
+{
+    UINT8 sessionId;
+
+    for (sessionId = 0; sessionId < CFU_MAX_SESSIONS; sessionId++)
+    {
+        if (s_sessions[sessionId].updateInProgress)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+#if CFU_REGION_CHECK || CFU_DELTA_PAYLOAD
+//****************************************************************************
+//
+// _IsWritableRange - Check that content may be written to a range of a
+//      component image according to its region table.
+//
+// Input Parameters
+//      const COMPONENT_REGISTRATION* pRegistration - The component.
+//      UINT32 address - Start of the range.
+//      UINT32 length - Length of the range.
+//
+// Return
+//      TRUE if the range lies in regions that follow each other without a
+//      gap and none of which is reserved, or if the component has no region
+//      table.
+//
+//****************************************************************************
+static BOOL _IsWritableRange(const COMPONENT_REGISTRATION* pRegistration, UINT32 address, UINT32 length)
+{
+    const COMPONENT_REGION* pRegion = pRegistration->pRegions;
+    const COMPONENT_REGION* pLast;
+    UINT32 count = pRegistration->regionCount;
+    UINT32 end = address + length;
+
+    if (pRegion == NULL)
+    {
+        return TRUE;
+    }
+
+    if ((count == 0) || (end < address))
+    {
+        return FALSE;
+    }
+
+    pLast = &pRegion[count - 1];
+
+    // Find the last region starting at or before the address. The halving
+    // only selects between two pointers, which compilers turn into a
+    // conditional move rather than a branch.
+    while (count > 1)
+    {
+        UINT32 half = count / 2;
+
+        pRegion = (pRegion[half].start <= address) ? &pRegion[half] : pRegion;
+        count -= half;
+    }
+
+    if (address < pRegion->start)
+    {
+        return FALSE;
+    }
+
+    // A block may run on into the regions that follow, e.g. from the code
+    // into the CRC
+    while ((pRegion->type != COMPONENT_REGION_RESERVED) && (end > pRegion->end) &&
+           (pRegion < pLast) && (pRegion[1].start == pRegion->end))
+    {
+        pRegion++;
+    }
+
+    return (pRegion->type != COMPONENT_REGION_RESERVED) && (end <= pRegion->end);
+}
+#endif
+
+#if CFU_REGION_CHECK
+//****************************************************************************
+//
+// _IsWritableBlock - Check the address of a content block as it arrives.
+//      Blocks of an encoded payload are addressed within the encoded stream,
+//      so their output is checked as it is written instead.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      FWUPDATE_CONTENT_COMMAND* pCommand - The content block.
+//
+// Return
+//      TRUE if the block may be written.
+//
+//****************************************************************************
+static BOOL _IsWritableBlock(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand)
+{
+#if CFU_ENCODED_PAYLOAD
+    if (pSession->payloadEncoding != PAYLOAD_ENCODING_NONE)
+    {
+        return TRUE;
+    }
+
+#endif
+    return _IsWritableRange(pSession->pActiveComponent, pCommand->address, pCommand->length);
+}
+#endif
+
+#if CFU_TIMING_STATS
+//****************************************************************************
+//
+// _ResetTiming - Clear the timing of a session when it accepts an offer,
+//      along with the timing of earlier updates of the same component in
+//      other sessions, so that ProcessCFWUGetTiming reports this update.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The session that accepted the offer.
+//
+//****************************************************************************
+static void _ResetTiming(CURRENT_OFFER_INFO* pSession)
+{
+    UINT8 sessionId;
+    UINT8 phase;
+
+    for (sessionId = 0; sessionId < CFU_MAX_SESSIONS; sessionId++)
+    {
+        CURRENT_OFFER_INFO* pOther = &s_sessions[sessionId];
+
+        if (pOther->activeComponentId == pSession->activeComponentId)
+        {
+            for (phase = 0; phase < CFU_TIMING_PHASE_COUNT; phase++)
+            {
+                pOther->timing[phase].count = 0;
+                pOther->timing[phase].minTicks = MAX_UINT32;
+                pOther->timing[phase].maxTicks = 0;
+                pOther->timing[phase].totalTicks = 0;
+            }
+        }
+    }
+}
+
+//****************************************************************************
+//
+// _RecordTiming - Add a timed call to the statistics of its phase.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT8 phase - CFU_TIMING_PHASE_xxx
+//      UINT32 start - ICompFwUpdateBspGetTicks before the call.
+//
+//****************************************************************************
+static void _RecordTiming(CURRENT_OFFER_INFO* pSession, UINT8 phase, UINT32 start)
+{
+    UINT32 ticks = ICompFwUpdateBspGetTicks() - start;
+    CFU_TIMING_STAT* pStat = &pSession->timing[phase];
+
+    if (ticks < pStat->minTicks)
+    {
+        pStat->minTicks = ticks;
+    }
+
+    if (ticks > pStat->maxTicks)
+    {
+        pStat->maxTicks = ticks;
+    }
+
+    pStat->totalTicks += ticks;
+    pStat->count++;
+}
+#endif
+
+#if CFU_VERSION_CACHE
+//****************************************************************************
+//
+// _RefreshVersionCache - Read a component's version and product info into
+// the version snapshot.
+//
+// Input Parameters
+//      UINT8 index - Position of the component in s_pComponents.
+//
+//****************************************************************************
+static void _RefreshVersionCache(UINT8 index)
+{
+    const COMPONENT_REGISTRATION* pRegistration = COMPONENT_AT(index);
+
+    _ComponentGetVersion(pRegistration, &s_versionCache[index][0]);
+    _ComponentGetProductInfo(pRegistration, &s_versionCache[index][1]);
+}
+#endif
+
+#if CFU_STREAMING_CRC
+//****************************************************************************
+//
+// _StartStreamingCrc - Reset the running CRC at the first block of an image.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT32 address - Address of the first block.
+//
+//****************************************************************************
+static void _StartStreamingCrc(CURRENT_OFFER_INFO* pSession, UINT32 address)
+{
+    const COMPONENT_REGISTRATION* pRegistration = pSession->pActiveComponent;
+
+    pSession->crcStreamValid = FALSE;
+    pSession->runningCrc = CRC16_INITIAL_VALUE;
+    pSession->nextCrcAddress = address;
+    pSession->embeddedCrcMask = 0;
+
+    if (pRegistration && (pRegistration->flags & COMPONENT_FLAG_STREAMING_CRC))
+    {
+        // The CRC bytes must be skipped while streaming so the offset is
+        // needed up front rather than on the last block.
+        MCU_STATUS result = _ComponentGetCrcOffset(pRegistration, &pSession->crcOffset);
+
+        pSession->crcStreamValid = MCU_SUCCESS(result);
+    }
+}
+
+//****************************************************************************
+//
+// _UpdateStreamingCrc - Add a written block to the running CRC.
+//      The embedded CRC bytes are excluded from the running CRC and captured
+//      instead, so the last block does not need to read them back. A block 
+//      that is not contiguous with the previous one invalidates the running
+//      CRC and the last block falls back to ICompFwUpdateBspCalcCRC.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT32 address - Address of the block.
+//      UINT8* pData - Block data.
+//      UINT8 length - Block length.
+//
+//****************************************************************************
+static void _UpdateStreamingCrc(CURRENT_OFFER_INFO* pSession, UINT32 address, UINT8* pData, UINT8 length)
+{
+    UINT32 crcOffset = pSession->crcOffset;
+    UINT32 end = address + length;
+
+    if (!pSession->crcStreamValid)
+    {
+        return;
+    }
+
+    if (address != pSession->nextCrcAddress)
+    {
+        pSession->crcStreamValid = FALSE;
+        return;
+    }
+
+    if ((crcOffset < end) && ((crcOffset + sizeof(UINT16)) > address))
+    {
+        // The block overlaps the embedded CRC field
+        UINT32 i;
+
+        for (i = 0; i < length; i++)
+        {
+            UINT32 fieldIndex = address + i - crcOffset;
+
+            if (fieldIndex < sizeof(UINT16))
+            {
+                pSession->embeddedCrc[fieldIndex] = pData[i];
+                pSession->embeddedCrcMask |= (UINT8)(1u << fieldIndex);
+            }
+            else
+            {
+                pSession->runningCrc = Crc16Update(pSession->runningCrc, &pData[i], 1);
+            }
+        }
+    }
+    else
+    {
+        pSession->runningCrc = Crc16Update(pSession->runningCrc, pData, length);
+    }
+
+    pSession->nextCrcAddress = end;
+}
+#endif
+
+#if CFU_STREAMING_DIGEST
+//****************************************************************************
+//
+// _StartStreamingDigest - Reset the image digest at the first block of an
+//                         image.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT32 address - Address of the first block.
+//
+//****************************************************************************
+static void _StartStreamingDigest(CURRENT_OFFER_INFO* pSession, UINT32 address)
+{
+    const COMPONENT_REGISTRATION* pRegistration = pSession->pActiveComponent;
+
+    pSession->digestStreamValid = pRegistration && 
+        (pRegistration->flags & COMPONENT_FLAG_STREAMING_DIGEST);
+    pSession->nextDigestAddress = address;
+    pSession->digestEndAddress = MAX_UINT32;
+
+    if (pRegistration && (pRegistration->digestLength != 0))
+    {
+        pSession->digestEndAddress = address + pRegistration->digestLength;
+    }
+
+    Sha256Init(&pSession->digest);
+}
+
+//****************************************************************************
+//
+// _UpdateStreamingDigest - Add a written block to the image digest. A block
+//      that is not contiguous with the previous one invalidates the digest
+//      and the last block falls back to ICompFwUpdateBspAuthenticateFWImage.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT32 address - Address of the block.
+//      UINT8* pData - Block data.
+//      UINT8 length - Block length.
+//
+//****************************************************************************
+static void _UpdateStreamingDigest(CURRENT_OFFER_INFO* pSession, UINT32 address, UINT8* pData, UINT8 length)
+{
+    if (!pSession->digestStreamValid)
+    {
+        return;
+    }
+
+    if (address != pSession->nextDigestAddress)
+    {
+        pSession->digestStreamValid = FALSE;
+        return;
+    }
+
+    if (address < pSession->digestEndAddress)
+    {
+        UINT32 digestBytes = pSession->digestEndAddress - address;
+
+        Sha256Update(&pSession->digest, pData, 
+                     (digestBytes < length) ? digestBytes : length);
+    }
+
+    pSession->nextDigestAddress = address + length;
+}
+#endif
+
+//****************************************************************************
+//
+// _AuthenticateImage - Authenticate a complete image, from its streaming
+//                      digest when there is one.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//
+// Return
+//      0 if the image is authentic.
+//
+//****************************************************************************
+static INT32 _AuthenticateImage(CURRENT_OFFER_INFO* pSession)
+{
+    INT32 result;
+    TIMING_START(start);
+
+#if CFU_STREAMING_DIGEST
+    if (pSession->digestStreamValid)
+    {
+        UINT8 digest[SHA256_DIGEST_SIZE];
+
+        Sha256Final(&pSession->digest, digest);
+        result = ICompFwUpdateBspAuthenticateDigest(digest, pSession->activeComponentId);
+    }
+    else
+#endif
+    if (pSession->pStorage->Authenticate)
+    {
+        result = pSession->pStorage->Authenticate(pSession->activeComponentId);
+    }
+    else
+    {
+        result = ICompFwUpdateBspAuthenticateFWImage();
+    }
+
+    TIMING_STOP(pSession, CFU_TIMING_PHASE_AUTHENTICATE, start);
+    return result;
+}
+
+#if CFU_LAZY_ERASE
+//****************************************************************************
+//
+// _StartLazyErase - Forget which sectors were erased at the first block of
+//                   an image.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//
+//****************************************************************************
+static void _StartLazyErase(CURRENT_OFFER_INFO* pSession)
+{
+    UINT32 sectorSize = pSession->pActiveComponent->eraseSectorSize;
+    UINT8 shift = 0;
+
+    memset(pSession->erasedSectors, 0, sizeof(pSession->erasedSectors));
+
+    while ((sectorSize >> shift) > 1)
+    {
+        shift++;
+    }
+
+    pSession->eraseSectorShift = shift;
+}
+
+//****************************************************************************
+//
+// _EraseSectors - Erase the sectors of the active component that a write
+//                 touches and that have not been erased yet.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT32 address - Start of the write.
+//      UINT32 length - Length of the write.
+//
+// Return
+//      0 on success.
+//
+//****************************************************************************
+static UINT32 _EraseSectors(CURRENT_OFFER_INFO* pSession, UINT32 address, UINT32 length)
+{
+    UINT8 shift = pSession->eraseSectorShift;
+    UINT32 sector;
+    UINT32 lastSector;
+
+    if ((pSession->pActiveComponent->eraseSectorSize == 0) || (length == 0))
+    {
+        // ICompFwUpdateBspPrepare erased the component
+        return 0;
+    }
+
+    sector = address >> shift;
+    lastSector = (address + length - 1) >> shift;
+
+    for (; sector <= lastSector; sector++)
+    {
+        UINT8 mask = (UINT8)(1u << (sector & 7));
+
+        if (sector >= (CFU_ERASE_BITMAP_BYTES * 8))
+        {
+            // Developer TODO - raise CFU_ERASE_BITMAP_BYTES or the sector size
+            return 1;
+        }
+
+        if (!(pSession->erasedSectors[sector >> 3] & mask))
+        {
+            UINT32 result;
+            TIMING_START(start);
+
+            result = pSession->pStorage->EraseSector(sector << shift, pSession->activeComponentId);
+            TIMING_STOP(pSession, CFU_TIMING_PHASE_ERASE, start);
+
+            if (result != 0)
+            {
+                return 1;
+            }
+
+            pSession->erasedSectors[sector >> 3] |= mask;
+        }
+    }
+
+    return 0;
+}
+#endif
+
+#if CFU_RANGE_COMPARE
+//****************************************************************************
+//
+// _HashRange - Calculate the SHA-256 of a range of the staging area.
+//
+// Input Parameters
+//      UINT32 address - Start of the range.
+//      UINT32 length - Length of the range.
+//      UINT8 componentId - The component.
+//      UINT8* pDigest - Receives the SHA256_DIGEST_SIZE byte digest.
+//
+// Return
+//      0 on success.
+//
+//****************************************************************************
+static UINT32 _HashRange(UINT32 address, UINT32 length, UINT8 componentId, UINT8* pDigest)
+{
+    UINT8 buffer[COMPARE_READ_CHUNK];
+    SHA256_CONTEXT context;
+    const COMPONENT_STORAGE* pStorage = _FindStorage(_FindComponent(componentId));
+
+    Sha256Init(&context);
+
+    while (length > 0)
+    {
+        UINT16 chunk = (length < sizeof(buffer)) ? (UINT16)length : (UINT16)sizeof(buffer);
+
+        if (pStorage->Read(address, buffer, chunk, componentId) != 0)
+        {
+            return 1;
+        }
+
+        Sha256Update(&context, buffer, chunk);
+        address += chunk;
+        length -= chunk;
+    }
+
+    Sha256Final(&context, pDigest);
+    return 0;
+}
+
+//****************************************************************************
+//
+// _MatchRanges - Compare ranges of the staging area of a component with
+//      hashes sent by the host. Lazy erase only erases sectors that are
+//      written, so the host can skip the content of the ranges that match.
+//      A range smaller than an erase sector could be erased with a
+//      neighbouring range and never matches.
+//
+// Input Parameters
+//      const COMPONENT_REGISTRATION* pRegistration - The component.
+//      UINT16 firstRange - Index of the first range.
+//      UINT8 rangeShift - Ranges are 1 << rangeShift bytes.
+//      UINT8 rangeCount - Number of hashes, at most 32.
+//      const UINT8* pHashes - The CFU_COMPARE_HASH_SIZE byte hash of each
+//              range, at any alignment.
+//
+// Return
+//      Bit n set when range firstRange + n matches.
+//
+//****************************************************************************
+static UINT32 _MatchRanges(const COMPONENT_REGISTRATION* pRegistration, UINT16 firstRange, UINT8 rangeShift, UINT8 rangeCount, const UINT8* pHashes)
+{
+    UINT8 componentId = pRegistration->componentId;
+    UINT32 matchMask = 0;
+    UINT8 i;
+
+    if ((pRegistration->eraseSectorSize == 0) || (rangeShift >= 32) ||
+        ((1UL << rangeShift) < pRegistration->eraseSectorSize))
+    {
+        return 0;
+    }
+
+    for (i = 0; i < rangeCount; i++)
+    {
+        UINT8 digest[SHA256_DIGEST_SIZE];
+
+        // The host sends the digest truncated to its first bytes
+        if ((_HashRange(((UINT32)firstRange + i) << rangeShift,
+                        1UL << rangeShift, componentId, digest) == 0) &&
+            (memcmp(digest, &pHashes[i * CFU_COMPARE_HASH_SIZE], CFU_COMPARE_HASH_SIZE) == 0))
+        {
+            matchMask |= 1UL << i;
+        }
+    }
+
+#if CFU_UNORDERED_CONTENT
+    // The host leaves these ranges out, so the next offer of the component
+    // is not granted out of order content.
+    if (matchMask != 0)
+    {
+        s_rangesMatched[componentId >> 3] |= (UINT8)(1u << (componentId & 7));
+    }
+#endif
+
+    return matchMask;
+}
+
+//****************************************************************************
+//
+// _CompareRanges - Answer a CFU_SPECIAL_OFFER_COMPARE_RANGES offer with the
+//      ranges whose hash matches the staging area of the component.
+//
+// Input Parameters
+//      FWUPDATE_COMPARE_OFFER_COMMAND* pCommand - The special offer.
+//      FWUPDATE_COMPARE_OFFER_RESPONSE* pResponse - The response to populate.
+//
+//****************************************************************************
+static void _CompareRanges(FWUPDATE_COMPARE_OFFER_COMMAND* pCommand, FWUPDATE_COMPARE_OFFER_RESPONSE* pResponse)
+{
+    // The response may share the buffer of the command
+    FWUPDATE_COMPARE_OFFER_COMMAND command = *pCommand;
+    UINT8 componentId = command.componentInfo.componentId;
+    const COMPONENT_REGISTRATION* pRegistration = _FindComponent(componentId);
+
+    memset(pResponse, 0, sizeof(FWUPDATE_COMPARE_OFFER_RESPONSE));
+    pResponse->token = command.componentInfo.token;
+
+    if (pRegistration == NULL)
+    {
+        pResponse->status = FIRMWARE_UPDATE_OFFER_REJECT;
+        pResponse->rejectReasonCode = FIRMWARE_OFFER_REJECT_INV_MCU;
+        return;
+    }
+
+    // The staging area is being written by another session
+    if (_FindSession(componentId))
+    {
+        pResponse->status = FIRMWARE_UPDATE_OFFER_BUSY;
+        pResponse->rejectReasonCode = FIRMWARE_UPDATE_OFFER_BUSY;
+        return;
+    }
+
+    pResponse->status = FIRMWARE_UPDATE_OFFER_COMMAND_READY;
+
+    if (command.rangeCount <= CFU_COMPARE_MAX_RANGES)
+    {
+        pResponse->matchMask = (UINT8)_MatchRanges(pRegistration, command.firstRange, command.rangeShift, 
+                                                   command.rangeCount, &command.hash[0][0]);
+    }
+}
+
+//****************************************************************************
+//
+// _CompareContent - Answer a content command flagged
+//      FIRMWARE_UPDATE_FLAG_COMPARE, which carries up to
+//      CFU_COMPARE_CONTENT_RANGES hashes instead of image data. It is not
+//      part of an update, so no session is used or ended.
+//
+// Input Parameters
+//      FWUPDATE_CONTENT_COMMAND* pCommand - The command to process.
+//      UINT8 status - FIRMWARE_UPDATE_STATUS_SUCCESS, or the error that the
+//              command already failed with.
+//      FWUPDATE_CONTENT_RESPONSE* pResponse - The response to populate. It
+//              may share the buffer of the command.
+//
+//****************************************************************************
+static void _CompareContent(FWUPDATE_CONTENT_COMMAND* pCommand, UINT8 status, FWUPDATE_CONTENT_RESPONSE* pResponse)
+{
+    const FWUPDATE_COMPARE_CONTENT* pCompare = (const FWUPDATE_COMPARE_CONTENT*)pCommand->pData;
+    UINT16 sequenceNumber = pCommand->sequenceNumber;
+    UINT8 hashLength = pCommand->length - (UINT8)offsetof(FWUPDATE_COMPARE_CONTENT, hash);
+    const COMPONENT_REGISTRATION* pRegistration = NULL;
+    UINT32 matchMask = 0;
+
+    if ((status != FIRMWARE_UPDATE_STATUS_SUCCESS) ||
+        (pCommand->length < offsetof(FWUPDATE_COMPARE_CONTENT, hash)) ||
+        (pCommand->length > sizeof(FWUPDATE_COMPARE_CONTENT)) ||
+        ((hashLength % CFU_COMPARE_HASH_SIZE) != 0))
+    {
+        status = FIRMWARE_UPDATE_STATUS_ERROR_INVALID;
+    }
+    else if ((pRegistration = _FindComponent(pCompare->componentId)) == NULL)
+    {
+        status = FIRMWARE_UPDATE_STATUS_ERROR_INVALID;
+    }
+    else if (_FindSession(pCompare->componentId))
+    {
+        // The staging area is being written by another session
+        status = FIRMWARE_UPDATE_STATUS_ERROR_PENDING;
+    }
+    else
+    {
+        matchMask = _MatchRanges(pRegistration, pCompare->firstRange, pCompare->rangeShift, 
+                                 hashLength / CFU_COMPARE_HASH_SIZE, &pCompare->hash[0][0]);
+    }
+
+    _BuildContentResponse(NULL, sequenceNumber, status, pResponse);
+    pResponse->selectiveAckMask = matchMask;
+}
+#endif
+
+#if CFU_CONTENT_WINDOW_MAX || CFU_RESUMABLE_TRANSFER || CFU_UNORDERED_CONTENT
+//****************************************************************************
+//
+// _CoalescesWrites - Check whether the blocks of a component are gathered
+//      into pages. Each page is programmed once, from its start, so such a
+//      component can only take its blocks in address order.
+//
+// Input Parameters
+//      const COMPONENT_REGISTRATION* pRegistration - The component.
+//
+// Return
+//      TRUE if blocks are written through the page write buffer.
+//
+//****************************************************************************
+static BOOL _CoalescesWrites(const COMPONENT_REGISTRATION* pRegistration)
+{
+#if CFU_WRITE_COALESCING
+    return pRegistration->writePageSize != 0;
+#else
+    return FALSE;
+#endif
+}
+#endif
+
+#if CFU_WRITE_COALESCING
+//****************************************************************************
+//
+// _CoalesceBlock - Gather a content block into the page write buffer.
+//      Whole pages are written as soon as they are complete. A block that is
+//      not contiguous with the buffered data first flushes the buffer.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT32 address - Address of the block.
+//      UINT8* pData - Block data.
+//      UINT8 length - Block length.
+//      UINT16* pSequenceNumber - Sequence number of the block. On failure
+//              it is updated to the sequence number of the first block
+//              whose data could not be written.
+//
+// Return
+//      0 on success.
+//
+//****************************************************************************
+static UINT32 _CoalesceBlock(CURRENT_OFFER_INFO* pSession, UINT32 address, UINT8* pData, UINT8 length, UINT16* pSequenceNumber)
+{
+    UINT32 pageMask = pSession->pActiveComponent->writePageSize - 1;
+
+    if ((pSession->writeBufferLength != 0) &&
+        (address != pSession->writeBufferAddress + pSession->writeBufferLength))
+    {
+        UINT32 result = _FlushWriteBuffer(pSession, pSequenceNumber);
+
+        if (result != 0)
+        {
+            return result;
+        }
+    }
+
+    while (length)
+    {
+        UINT8* pBuffer = (UINT8*)pSession->writeBuffer[pSession->writeBufferIndex];
+        UINT32 room;
+        UINT32 chunk;
+
+        if (pSession->writeBufferLength == 0)
+        {
+            pSession->writeBufferAddress = address;
+            pSession->writeBufferSequence = *pSequenceNumber;
+        }
+
+        // Bytes left until the end of the page the buffer starts in
+        room = ((pSession->writeBufferAddress | pageMask) + 1) - 
+               (pSession->writeBufferAddress + pSession->writeBufferLength);
+        chunk = (length < room) ? length : room;
+
+        memcpy(&pBuffer[pSession->writeBufferLength], pData, chunk);
+        pSession->writeBufferLength += (UINT16)chunk;
+        address += chunk;
+        pData += chunk;
+        length -= (UINT8)chunk;
+
+        if (chunk == room)
+        {
+            UINT32 result = _FlushWriteBuffer(pSession, pSequenceNumber);
+
+            if (result != 0)
+            {
+                return result;
+            }
+        }
+    }
+
+    return 0;
+}
+#endif
+
+//****************************************************************************
+//
+// _FlushWriteBuffer - Write out any data held in the page write buffer.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT16* pSequenceNumber - On failure, updated to the sequence number
+//              of the first block whose data could not be written.
+//
+// Return
+//      0 on success.
+//
+//****************************************************************************
+static UINT32 _FlushWriteBuffer(CURRENT_OFFER_INFO* pSession, UINT16* pSequenceNumber)
+{
+#if CFU_WRITE_COALESCING
+    UINT16 length = pSession->writeBufferLength;
+    UINT8* pBuffer = (UINT8*)pSession->writeBuffer[pSession->writeBufferIndex];
+    UINT32 result;
+
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    pSession->writeBufferLength = 0;
+
+#if CFU_ASYNC_WRITE
+    if (pSession->pActiveComponent->flags & COMPONENT_FLAG_ASYNC_WRITE)
+    {
+#if CFU_WRITE_LIST
+        if (pSession->pActiveComponent->flags & COMPONENT_FLAG_WRITE_LIST)
+        {
+            return _QueueWritePage(pSession, pBuffer, length, pSequenceNumber);
+        }
+
+#endif
+        // Only one page is programmed at a time. Wait for the page in the
+        // other buffer, then start this one and switch buffers so the next
+        // blocks can be staged while it is programmed.
+        result = _CheckAsyncWrite(pSession, TRUE, pSequenceNumber);
+
+        if (result != 0)
+        {
+            return result;
+        }
+
+#if CFU_LAZY_ERASE
+        if (_EraseSectors(pSession, pSession->writeBufferAddress, length) != 0)
+        {
+            *pSequenceNumber = pSession->writeBufferSequence;
+            return 1;
+        }
+#endif
+
+        pSession->asyncWriteSequence = pSession->writeBufferSequence;
+        pSession->asyncWriteResult = 0;
+        pSession->asyncWriteInFlight = TRUE;
+
+        TIMING_START(start);
+        result = pSession->pStorage->WritePageAsync(pSession->writeBufferAddress, 
+                    pBuffer, length, pSession->activeComponentId, 
+                    _AsyncWriteCompleteCallback);
+        TIMING_STOP(pSession, CFU_TIMING_PHASE_WRITE, start);
+
+        if (result != 0)
+        {
+            pSession->asyncWriteInFlight = FALSE;
+            *pSequenceNumber = pSession->writeBufferSequence;
+            return 1;
+        }
+
+        pSession->writeBufferIndex ^= 1;
+        return 0;
+    }
+#endif
+
+#if CFU_LAZY_ERASE
+    if (_EraseSectors(pSession, pSession->writeBufferAddress, length) != 0)
+    {
+        *pSequenceNumber = pSession->writeBufferSequence;
+        return 1;
+    }
+#endif
+
+    TIMING_START(start);
+    result = pSession->pStorage->WritePage(pSession->writeBufferAddress, 
+                pBuffer, length, pSession->activeComponentId);
+    TIMING_STOP(pSession, CFU_TIMING_PHASE_WRITE, start);
+
+    if (result != 0)
+    {
+        *pSequenceNumber = pSession->writeBufferSequence;
+        return 1;
+    }
+#endif
+
+    return 0;
+}
+
+#if CFU_ASYNC_WRITE
+//****************************************************************************
+//
+// _AsyncWriteCompleteCallback - Called by the BSP when a page started with
+//                               ICompFwUpdateBspWritePageAsync, or a list
+//                               started with ICompFwUpdateBspWriteList, is
+//                               programmed. May be called from interrupt
+//                               context.
+//
+// Input Parameters
+//      UINT8 componentId - The component the page was written to.
+//      UINT32 result - 0 on success.
+//
+//****************************************************************************
+static void _AsyncWriteCompleteCallback(UINT8 componentId, UINT32 result)
+{
+    UINT8 sessionId;
+
+    // The session may already have ended with an error, so match on the
+    // page in flight rather than with _FindSession.
+    for (sessionId = 0; sessionId < CFU_MAX_SESSIONS; sessionId++)
+    {
+        CURRENT_OFFER_INFO* pSession = &s_sessions[sessionId];
+
+        if (pSession->asyncWriteInFlight && (pSession->activeComponentId == componentId))
+        {
+            pSession->asyncWriteResult = result;
+            pSession->asyncWriteInFlight = FALSE;
+            break;
+        }
+    }
+}
+
+//****************************************************************************
+//
+// _CheckAsyncWrite - Collect the result of the page being programmed.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      BOOL wait - Wait for a page still being programmed to finish.
+//      UINT16* pSequenceNumber - On failure, updated to the sequence number
+//              of the first block whose data could not be written.
+//
+// Return
+//      0 unless a page write has failed.
+//
+//****************************************************************************
+static UINT32 _CheckAsyncWrite(CURRENT_OFFER_INFO* pSession, BOOL wait, UINT16* pSequenceNumber)
+{
+    while (wait && pSession->asyncWriteInFlight)
+    {
+        ICompFwUpdateBspWaitWrite(pSession->activeComponentId);
+    }
+
+    if (!pSession->asyncWriteInFlight && (pSession->asyncWriteResult != 0))
+    {
+        pSession->asyncWriteResult = 0;
+        *pSequenceNumber = pSession->asyncWriteSequence;
+        return 1;
+    }
+
+    return 0;
+}
+#endif
+
+#if CFU_WRITE_LIST
+//****************************************************************************
+//
+// _QueueWritePage - Add the page in the current write buffer to the list
+//                   being filled, and start the list once it is full.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT8* pBuffer - The current write buffer.
+//      UINT16 length - Length of the data in it.
+//      UINT16* pSequenceNumber - On failure, updated to the sequence number
+//              of the first block whose data could not be written.
+//
+// Return
+//      0 on success.
+//
+//****************************************************************************
+static UINT32 _QueueWritePage(CURRENT_OFFER_INFO* pSession, UINT8* pBuffer, UINT16 length, UINT16* pSequenceNumber)
+{
+    CFU_WRITE_DESCRIPTOR* pDescriptor;
+
+    if (pSession->writeListCount == 0)
+    {
+        pSession->writeListSequence = pSession->writeBufferSequence;
+    }
+
+    pDescriptor = &pSession->writeList[pSession->writeListHalf][pSession->writeListCount++];
+    pDescriptor->offset = pSession->writeBufferAddress;
+    pDescriptor->pData = pBuffer;
+    pDescriptor->length = length;
+
+    // The next page is gathered in the next buffer of the same list
+    pSession->writeBufferIndex++;
+
+    if (pSession->writeListCount == CFU_WRITE_LIST_PAGES)
+    {
+        return _StartWriteList(pSession, pSequenceNumber);
+    }
+
+    return 0;
+}
+
+//****************************************************************************
+//
+// _StartWriteList - Start programming the list being filled, if it holds any
+//                   page. Waits for the previous list first, then switches
+//                   to the other half of the write buffers.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT16* pSequenceNumber - On failure, updated to the sequence number
+//              of the first block whose data could not be written.
+//
+// Return
+//      0 on success.
+//
+//****************************************************************************
+static UINT32 _StartWriteList(CURRENT_OFFER_INFO* pSession, UINT16* pSequenceNumber)
+{
+    CFU_WRITE_DESCRIPTOR* pList = pSession->writeList[pSession->writeListHalf];
+    UINT8 count = pSession->writeListCount;
+    UINT32 result;
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    result = _CheckAsyncWrite(pSession, TRUE, pSequenceNumber);
+
+    if (result != 0)
+    {
+        return result;
+    }
+
+#if CFU_LAZY_ERASE
+    // Erasing is not part of the list, and must not overlap the previous one
+    {
+        UINT8 i;
+
+        for (i = 0; i < count; i++)
+        {
+            if (_EraseSectors(pSession, pList[i].offset, pList[i].length) != 0)
+            {
+                *pSequenceNumber = pSession->writeListSequence;
+                return 1;
+            }
+        }
+    }
+#endif
+
+    pSession->asyncWriteSequence = pSession->writeListSequence;
+    pSession->asyncWriteResult = 0;
+    pSession->asyncWriteInFlight = TRUE;
+
+    TIMING_START(start);
+    result = pSession->pStorage->WriteList(pList, count, pSession->activeComponentId, 
+                                           _AsyncWriteCompleteCallback);
+    TIMING_STOP(pSession, CFU_TIMING_PHASE_WRITE, start);
+
+    if (result != 0)
+    {
+        pSession->asyncWriteInFlight = FALSE;
+        *pSequenceNumber = pSession->writeListSequence;
+        return 1;
+    }
+
+    pSession->writeListHalf ^= 1;
+    _ResetWriteList(pSession);
+    return 0;
+}
+
+//****************************************************************************
+//
+// _ResetWriteList - Empty the list being filled, dropping its pages.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//
+//****************************************************************************
+static void _ResetWriteList(CURRENT_OFFER_INFO* pSession)
+{
+    pSession->writeListCount = 0;
+    pSession->writeBufferIndex = (UINT8)(pSession->writeListHalf * CFU_WRITE_LIST_PAGES);
+}
+#endif
+
+//****************************************************************************
+//
+// _CompleteWrites - Write out all buffered data and wait until it has been
+//                   programmed, then flush the storage. Used before the
+//                   image is verified.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT16* pSequenceNumber - On failure, updated to the sequence number
+//              of the first block whose data could not be written.
+//
+// Return
+//      0 on success.
+//
+//****************************************************************************
+static UINT32 _CompleteWrites(CURRENT_OFFER_INFO* pSession, UINT16* pSequenceNumber)
+{
+    UINT32 result = _FlushWriteBuffer(pSession, pSequenceNumber);
+
+#if CFU_WRITE_LIST
+    if (result == 0)
+    {
+        result = _StartWriteList(pSession, pSequenceNumber);
+    }
+#endif
+#if CFU_ASYNC_WRITE
+    if (result == 0)
+    {
+        result = _CheckAsyncWrite(pSession, TRUE, pSequenceNumber);
+    }
+#endif
+
+    if ((result == 0) && pSession->pStorage->Flush)
+    {
+        result = pSession->pStorage->Flush(pSession->activeComponentId);
+    }
+
+    return result;
+}
+
+//****************************************************************************
+//
+// _WriteData - Write image data to the active component.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT32 address - Where the data goes in the image.
+//      UINT8* pData - The data.
+//      UINT8 length - Length of the data.
+//      UINT16* pSequenceNumber - Sequence number of the block. On failure
+//              it is updated to the sequence number of the first block
+//              whose data could not be written.
+//
+// Return
+//      0 on success.
+//
+//****************************************************************************
+static UINT32 _WriteData(CURRENT_OFFER_INFO* pSession, UINT32 address, UINT8* pData, UINT8 length, UINT16* pSequenceNumber)
+{
+    UINT32 result;
+
+#if CFU_ASYNC_WRITE
+    // A page that failed to program since the last block is reported now
+    if (_CheckAsyncWrite(pSession, FALSE, pSequenceNumber) != 0)
+    {
+        return 1;
+    }
+#endif
+#if CFU_REGION_CHECK && CFU_ENCODED_PAYLOAD
+    // Decoded data is only checked here, see _IsWritableBlock
+    if ((pSession->payloadEncoding != PAYLOAD_ENCODING_NONE) &&
+        !_IsWritableRange(pSession->pActiveComponent, address, length))
+    {
+        return 1;
+    }
+#endif
+
+#if CFU_WRITE_COALESCING
+    const COMPONENT_REGISTRATION* pRegistration = pSession->pActiveComponent;
+
+    if (pRegistration && (pRegistration->writePageSize != 0))
+    {
+        // Developer TODO - raise CFU_WRITE_BUFFER_SIZE to the largest page size
+        ASSERT(pRegistration->writePageSize <= CFU_WRITE_BUFFER_SIZE);
+
+        result = _CoalesceBlock(pSession, address, pData, length, pSequenceNumber);
+    }
+    else
+#endif
+    {
+#if CFU_LAZY_ERASE
+        result = _EraseSectors(pSession, address, length);
+
+        if (result == 0)
+#endif
+        {
+            TIMING_START(start);
+            result = pSession->pStorage->Write(address, pData, length, 
+                                               pSession->activeComponentId);
+            TIMING_STOP(pSession, CFU_TIMING_PHASE_WRITE, start);
+        }
+    }
+
+#if CFU_STREAMING_CRC
+    if (result == 0)
+    {
+        _UpdateStreamingCrc(pSession, address, pData, length);
+    }
+#endif
+#if CFU_STREAMING_DIGEST
+    if (result == 0)
+    {
+        _UpdateStreamingDigest(pSession, address, pData, length);
+    }
+#endif
+
+    return result;
+}
+
+//****************************************************************************
+//
+// _WriteBlock - Write a content block to the active component.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      FWUPDATE_CONTENT_COMMAND* pCommand - The content block.
+//      UINT16* pSequenceNumber - Sequence number of the block. On failure
+//              it is updated to the sequence number of the first block
+//              whose data could not be written.
+//
+// Return
+//      0 on success.
+//
+//****************************************************************************
+static UINT32 _WriteBlock(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand, UINT16* pSequenceNumber)
+{
+#if CFU_DELTA_PAYLOAD
+    if (pSession->payloadEncoding == PAYLOAD_ENCODING_DELTA)
+    {
+        // The block holds patch operations rather than image data
+        return _ApplyDelta(pSession, pCommand, pSequenceNumber);
+    }
+#endif
+#if CFU_COMPRESSED_PAYLOAD
+    if (pSession->payloadEncoding == PAYLOAD_ENCODING_COMPRESSED)
+    {
+        return _Decompress(pSession, pCommand, pSequenceNumber);
+    }
+#endif
+
+    return _WriteData(pSession, pCommand->address, pCommand->pData, 
+                      pCommand->length, pSequenceNumber);
+}
+
+#if CFU_DELTA_PAYLOAD
+//****************************************************************************
+//
+// _CopyFromCurrentImage - Copy part of the image the component is running
+//                         to the image being staged, after checking the
+//                         source against the region table, or against the
+//                         end of the CRC when there is none.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT32 length - Number of bytes to copy from deltaSource.
+//      UINT16* pSequenceNumber - Sequence number of the block. On failure
+//              it is updated to the sequence number of the first block
+//              whose data could not be written.
+//
+// Return
+//      0 on success.
+//
+//****************************************************************************
+static UINT32 _CopyFromCurrentImage(CURRENT_OFFER_INFO* pSession, UINT32 length, UINT16* pSequenceNumber)
+{
+    UINT8 buffer[CFU_DELTA_COPY_CHUNK];
+    const COMPONENT_REGISTRATION* pRegistration = pSession->pActiveComponent;
+    UINT32 end = pSession->deltaSource + length;
+    UINT32 crcOffset;
+
+    if (end < pSession->deltaSource)
+    {
+        return 1;
+    }
+
+    // The running image has the layout of the staged one, so the copy must
+    // come from where content may be written. Without a region table the
+    // image is taken to end with its CRC.
+    if (pRegistration->pRegions != NULL)
+    {
+        if (!_IsWritableRange(pRegistration, pSession->deltaSource, length))
+        {
+            return 1;
+        }
+    }
+    else if (!MCU_SUCCESS(_ComponentGetCrcOffset(pRegistration, &crcOffset)) ||
+             ((end > crcOffset) && ((end - crcOffset) > sizeof(UINT16))))
+    {
+        return 1;
+    }
+
+    while (length > 0)
+    {
+        UINT8 chunk = (length < sizeof(buffer)) ? (UINT8)length : (UINT8)sizeof(buffer);
+
+        if (pSession->pStorage->ReadCurrent(pSession->deltaSource, buffer, chunk, 
+                    pSession->activeComponentId) != 0)
+        {
+            return 1;
+        }
+
+        if (_WriteData(pSession, pSession->outputAddress, buffer, chunk, 
+                    pSequenceNumber) != 0)
+        {
+            return 1;
+        }
+
+        pSession->deltaSource += chunk;
+        pSession->outputAddress += chunk;
+        length -= chunk;
+    }
+
+    return 0;
+}
+
+//****************************************************************************
+//
+// _ApplyDelta - Decode the patch operations of a delta content block and
+//      write the image data they produce. Operations may span blocks; the
+//      decoder state is kept in the session. The patch stream must arrive
+//      in order, the address of each block being its offset in the stream.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      FWUPDATE_CONTENT_COMMAND* pCommand - The content block.
+//      UINT16* pSequenceNumber - Sequence number of the block. On failure
+//              it is updated to the sequence number of the first block
+//              whose data could not be written.
+//
+// Return
+//      0 on success.
+//
+//****************************************************************************
+static UINT32 _ApplyDelta(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand, UINT16* pSequenceNumber)
+{
+    UINT8* pData = pCommand->pData;
+    UINT8 length = pCommand->length;
+
+    if (pCommand->address != pSession->streamOffset)
+    {
+        return 1;
+    }
+
+    pSession->streamOffset += length;
+
+    while (length > 0)
+    {
+        if (pSession->deltaOp == 0)
+        {
+            // Start of an operation
+            switch (*pData)
+            {
+            case CFU_DELTA_OP_COPY:
+                pSession->deltaArgSize = 2 * sizeof(UINT32);
+                break;
+            case CFU_DELTA_OP_INSERT:
+                pSession->deltaArgSize = sizeof(UINT16);
+                break;
+            case CFU_DELTA_OP_SEEK:
+                pSession->deltaArgSize = sizeof(UINT32);
+                break;
+            default:
+                return 1;
+            }
+
+            pSession->deltaOp = *pData++;
+            pSession->deltaArgLength = 0;
+            length--;
+        }
+        else if (pSession->deltaArgLength < pSession->deltaArgSize)
+        {
+            // Operation arguments, little endian
+            pSession->deltaArgs[pSession->deltaArgLength++] = *pData++;
+            length--;
+
+            if (pSession->deltaArgLength < pSession->deltaArgSize)
+            {
+                continue;
+            }
+
+            if (pSession->deltaOp == CFU_DELTA_OP_COPY)
+            {
+                UINT32 copyLength;
+
+                memcpy(&pSession->deltaSource, &pSession->deltaArgs[0], sizeof(UINT32));
+                memcpy(&copyLength, &pSession->deltaArgs[sizeof(UINT32)], sizeof(UINT32));
+                pSession->deltaOp = 0;
+
+                if (_CopyFromCurrentImage(pSession, copyLength, pSequenceNumber) != 0)
+                {
+                    return 1;
+                }
+            }
+            else if (pSession->deltaOp == CFU_DELTA_OP_INSERT)
+            {
+                UINT16 insertLength;
+
+                memcpy(&insertLength, pSession->deltaArgs, sizeof(UINT16));
+                pSession->deltaRemaining = insertLength;
+
+                if (insertLength == 0)
+                {
+                    pSession->deltaOp = 0;
+                }
+            }
+            else
+            {
+                memcpy(&pSession->outputAddress, pSession->deltaArgs, sizeof(UINT32));
+                pSession->deltaOp = 0;
+            }
+        }
+        else
+        {
+            // Literal bytes of an insert
+            UINT8 chunk = (length < pSession->deltaRemaining) ? 
+                          length : (UINT8)pSession->deltaRemaining;
+
+            if (_WriteData(pSession, pSession->outputAddress, pData, chunk, 
+                        pSequenceNumber) != 0)
+            {
+                return 1;
+            }
+
+            pSession->outputAddress += chunk;
+            pSession->deltaRemaining -= chunk;
+            pData += chunk;
+            length -= chunk;
+
+            if (pSession->deltaRemaining == 0)
+            {
+                pSession->deltaOp = 0;
+            }
+        }
+    }
+
+    return 0;
+}
+#endif
+
+#if CFU_COMPRESSED_PAYLOAD
+//****************************************************************************
+//
+// _WriteDecompressed - Write decompressed bytes to the image being staged
+//                      and append them to the history.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT8* pData - The decompressed bytes.
+//      UINT8 length - Number of bytes.
+//      UINT16* pSequenceNumber - Sequence number of the block. On failure
+//              it is updated to the sequence number of the first block
+//              whose data could not be written.
+//
+// Return
+//      0 on success.
+//
+//****************************************************************************
+static UINT32 _WriteDecompressed(CURRENT_OFFER_INFO* pSession, UINT8* pData, UINT8 length, UINT16* pSequenceNumber)
+{
+    UINT16 position = (UINT16)(pSession->outputAddress & (CFU_COMPRESS_WINDOW - 1));
+    UINT16 first = CFU_COMPRESS_WINDOW - position;
+
+    if (_WriteData(pSession, pSession->outputAddress, pData, length, pSequenceNumber) != 0)
+    {
+        return 1;
+    }
+
+    // The history is a ring buffer, so the bytes may wrap around its end
+    if (first > length)
+    {
+        first = length;
+    }
+
+    memcpy(&pSession->compressHistory[position], pData, first);
+    memcpy(pSession->compressHistory, pData + first, length - first);
+    pSession->outputAddress += length;
+
+    return 0;
+}
+
+//****************************************************************************
+//
+// _CopyMatch - Repeat earlier output of the decompressor.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT16 distance - How far back the match starts. It may be shorter
+//              than the match, which then repeats its own output.
+//      UINT8 length - Length of the match.
+//      UINT16* pSequenceNumber - Sequence number of the block. On failure
+//              it is updated to the sequence number of the first block
+//              whose data could not be written.
+//
+// Return
+//      0 on success.
+//
+//****************************************************************************
+static UINT32 _CopyMatch(CURRENT_OFFER_INFO* pSession, UINT16 distance, UINT8 length, UINT16* pSequenceNumber)
+{
+    UINT8 buffer[(CFU_COMPRESS_TOKEN_MATCH - 1) + CFU_COMPRESS_MIN_MATCH];
+    UINT32 source = pSession->outputAddress - distance;
+    UINT8 i;
+
+    if ((distance == 0) || (distance > CFU_COMPRESS_WINDOW) || 
+        (distance > pSession->outputAddress))
+    {
+        return 1;
+    }
+
+    for (i = 0; i < length; i++)
+    {
+        buffer[i] = (i < distance) ? 
+                    pSession->compressHistory[(source + i) & (CFU_COMPRESS_WINDOW - 1)] :
+                    buffer[i - distance];
+    }
+
+    return _WriteDecompressed(pSession, buffer, length, pSequenceNumber);
+}
+
+//****************************************************************************
+//
+// _Decompress - Decompress a content block and write the image data it
+//      holds. The stream is a sequence of tokens, which may span blocks:
+//          0x00-0x7F   literal run, followed by (token + 1) bytes
+//          0x80-0xFF   match of ((token & 0x7F) + CFU_COMPRESS_MIN_MATCH)
+//                      bytes, followed by its UINT16 distance
+//      The stream must arrive in order, the address of each block being its
+//      offset in the stream.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      FWUPDATE_CONTENT_COMMAND* pCommand - The content block.
+//      UINT16* pSequenceNumber - Sequence number of the block. On failure
+//              it is updated to the sequence number of the first block
+//              whose data could not be written.
+//
+// Return
+//      0 on success.
+//
+//****************************************************************************
+static UINT32 _Decompress(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand, UINT16* pSequenceNumber)
+{
+    UINT8* pData = pCommand->pData;
+    UINT8 length = pCommand->length;
+
+    if (pCommand->address != pSession->streamOffset)
+    {
+        return 1;
+    }
+
+    pSession->streamOffset += length;
+
+    while (length > 0)
+    {
+        if (pSession->compressLiterals > 0)
+        {
+            UINT8 chunk = (length < pSession->compressLiterals) ? 
+                          length : pSession->compressLiterals;
+
+            if (_WriteDecompressed(pSession, pData, chunk, pSequenceNumber) != 0)
+            {
+                return 1;
+            }
+
+            pSession->compressLiterals -= chunk;
+            pData += chunk;
+            length -= chunk;
+        }
+        else if (pSession->compressMatchLength > 0)
+        {
+            // Match distance, little endian
+            pSession->compressArgs[pSession->compressArgLength++] = *pData++;
+            length--;
+
+            if (pSession->compressArgLength == sizeof(UINT16))
+            {
+                UINT16 distance;
+                UINT8 matchLength = pSession->compressMatchLength;
+
+                memcpy(&distance, pSession->compressArgs, sizeof(UINT16));
+                pSession->compressMatchLength = 0;
+
+                if (_CopyMatch(pSession, distance, matchLength, pSequenceNumber) != 0)
+                {
+                    return 1;
+                }
+            }
+        }
+        else if (*pData & CFU_COMPRESS_TOKEN_MATCH)
+        {
+            pSession->compressMatchLength = (*pData++ & ~CFU_COMPRESS_TOKEN_MATCH) + 
+                                            CFU_COMPRESS_MIN_MATCH;
+            pSession->compressArgLength = 0;
+            length--;
+        }
+        else
+        {
+            pSession->compressLiterals = *pData++ + 1;
+            length--;
+        }
+    }
+
+    return 0;
+}
+#endif
+
+//****************************************************************************
+//
+// _VerifyImageCrc - Check the CRC of the downloaded image against the CRC
+//                   embedded in the image.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT32 crcOffset - Location of the embedded CRC.
+//      UINT8 componentId - The component being updated.
+//
+// Return
+//      FIRMWARE_UPDATE_STATUS_SUCCESS or FIRMWARE_UPDATE_STATUS_ERROR_CRC.
+//
+//****************************************************************************
+static UINT8 _VerifyImageCrc(CURRENT_OFFER_INFO* pSession, UINT32 crcOffset, UINT8 componentId)
+{
+    UINT16 crc;
+    UINT16 calculatedCrc;
+
+#if CFU_STREAMING_CRC
+    if (pSession->crcStreamValid)
+    {
+        if (pSession->embeddedCrcMask == ((1u << sizeof(UINT16)) - 1))
+        {
+            memcpy(&crc, pSession->embeddedCrc, sizeof(crc));
+        }
+        else if (pSession->pStorage->Read(crcOffset, (UINT8*)&crc, sizeof(crc), componentId) != 0)
+        {
+            return FIRMWARE_UPDATE_STATUS_ERROR_CRC;
+        }
+
+        if (crc != pSession->runningCrc)
+        {
+            return FIRMWARE_UPDATE_STATUS_ERROR_CRC;
+        }
+
+        if (!(pSession->pActiveComponent->flags & COMPONENT_FLAG_FULL_IMAGE_CRC))
+        {
+            return FIRMWARE_UPDATE_STATUS_SUCCESS;
+        }
+
+        // Opt-in re-verification of the whole staged image below
+    }
+#endif
+
+    if (pSession->pStorage->CalcCRC(&calculatedCrc,  componentId) != 0)
+    {
+        return FIRMWARE_UPDATE_STATUS_ERROR_CRC;
+    }
+    else if (pSession->pStorage->Read(crcOffset, (UINT8*)&crc, sizeof(crc), componentId) != 0)
+    {
+        return FIRMWARE_UPDATE_STATUS_ERROR_CRC;
+    }
+    else if (crc != calculatedCrc)
+    {
+        return FIRMWARE_UPDATE_STATUS_ERROR_CRC;
+    }
+
+    return FIRMWARE_UPDATE_STATUS_SUCCESS;
+}
+
+//******************************************************************************
+//
+// _StartImage - Prepare the active component for a new image and write the
+//               first block.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      FWUPDATE_CONTENT_COMMAND* pCommand - The first block.
+//      UINT16* pSequenceNumber - Sequence number to report in the response.
+//
+// Return
+//      FIRMWARE_UPDATE_STATUS_xxx
+//
+//******************************************************************************
+static UINT8 _StartImage(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand, UINT16* pSequenceNumber)
+{
+    UINT8 status = FIRMWARE_UPDATE_STATUS_SUCCESS;
+    UINT32 result;
+
+    // FWU: Received first block flag, starting FWupdate.
+
+#if CFU_RESUMABLE_TRANSFER
+    // The stored resume point no longer describes the staging bank once it
+    // is prepared again, so it is dropped first.
+    pSession->resumePending = FALSE;
+    pSession->checkpoint.address = pCommand->address;
+
+    if (_ClearCheckpoint(pSession) != 0)
+    {
+        return FIRMWARE_UPDATE_STATUS_ERROR_PREPARE;
+    }
+
+#endif
+#if CFU_ASYNC_WRITE
+    // Let a page left over from an abandoned update finish before the
+    // component is prepared again, and drop its result.
+    _CheckAsyncWrite(pSession, TRUE, pSequenceNumber);
+    *pSequenceNumber = pCommand->sequenceNumber;
+
+#endif
+#if CFU_UNORDERED_CONTENT && CFU_RANGE_COMPARE
+    // Ranges compared before this image no longer matter
+    s_rangesMatched[pSession->activeComponentId >> 3] &=
+        (UINT8)~(1u << (pSession->activeComponentId & 7));
+
+#endif
+    TIMING_START(start);
+    result = pSession->pStorage->Prepare(pSession->activeComponentId);
+    TIMING_STOP(pSession, CFU_TIMING_PHASE_PREPARE, start);
+
+    if (result == 0)
+    {
+#if CFU_ENCODED_PAYLOAD
+        // A decoded image starts at address 0, unless a delta patch seeks
+        pSession->streamOffset = 0;
+        pSession->outputAddress = 0;
+#endif
+#if CFU_DELTA_PAYLOAD
+        pSession->deltaOp = 0;
+#endif
+#if CFU_COMPRESSED_PAYLOAD
+        pSession->compressLiterals = 0;
+        pSession->compressMatchLength = 0;
+#endif
+#if CFU_STREAMING_CRC
+#if CFU_ENCODED_PAYLOAD
+        _StartStreamingCrc(pSession, (pSession->payloadEncoding != PAYLOAD_ENCODING_NONE) ? 
+                                        0 : pCommand->address);
+#else
+        _StartStreamingCrc(pSession, pCommand->address);
+#endif
+#endif
+#if CFU_STREAMING_DIGEST
+#if CFU_ENCODED_PAYLOAD
+        _StartStreamingDigest(pSession, (pSession->payloadEncoding != PAYLOAD_ENCODING_NONE) ? 
+                                        0 : pCommand->address);
+#else
+        _StartStreamingDigest(pSession, pCommand->address);
+#endif
+#endif
+#if CFU_WRITE_COALESCING
+        pSession->writeBufferLength = 0;
+#endif
+#if CFU_WRITE_LIST
+        _ResetWriteList(pSession);
+#endif
+#if CFU_LAZY_ERASE
+        _StartLazyErase(pSession);
+#endif
+        if (_WriteBlock(pSession, pCommand, pSequenceNumber) != 0)
+        {
+            status = FIRMWARE_UPDATE_STATUS_ERROR_WRITE;
+        }
+    }
+    else
+    {
+        status = FIRMWARE_UPDATE_STATUS_ERROR_PREPARE;
+    }
+
+    return status;
+}
+
+//******************************************************************************
+//
+// _FinishImage - Complete an image once its last block has been written:
+//                verify it and hand it over to the component.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT16* pSequenceNumber - Sequence number to report in the response.
+//
+// Return
+//      FIRMWARE_UPDATE_STATUS_xxx
+//
+//******************************************************************************
+static UINT8 _FinishImage(CURRENT_OFFER_INFO* pSession, UINT16* pSequenceNumber)
+{
+    UINT8 status = FIRMWARE_UPDATE_STATUS_SUCCESS;
+    UINT8 componentId = pSession->activeComponentId;
+
+    // The registration was looked up once when the offer was accepted.
+    const COMPONENT_REGISTRATION* pRegistration = pSession->pActiveComponent;
+
+    MCU_STATUS getCrcOffsetResult = MCU_STATUS_DEFAULT_ERROR;
+    UINT32 crcOffset = 0;
+
+#if CFU_BACKGROUND_VERIFY
+    // Leave the work to FirmwareUpdateBackgroundTask, which calls back in
+    // with verifyPending set.
+    if (pSession->backgroundVerify && !pSession->verifyPending)
+    {
+        pSession->verifyPending = TRUE;
+        ICompFwUpdateBspSignalVerifyPending();
+        return FIRMWARE_UPDATE_STATUS_ERROR_PENDING;
+    }
+
+#endif
+#if CFU_DELTA_PAYLOAD
+    // The patch stream must not end in the middle of an operation
+    if ((pSession->payloadEncoding == PAYLOAD_ENCODING_DELTA) && (pSession->deltaOp != 0))
+    {
+        return FIRMWARE_UPDATE_STATUS_ERROR_INVALID;
+    }
+
+#endif
+#if CFU_COMPRESSED_PAYLOAD
+    // Nor may the compressed stream end in the middle of a token
+    if ((pSession->payloadEncoding == PAYLOAD_ENCODING_COMPRESSED) && 
+        ((pSession->compressLiterals != 0) || (pSession->compressMatchLength != 0)))
+    {
+        return FIRMWARE_UPDATE_STATUS_ERROR_INVALID;
+    }
+
+#endif
+    // All blocks must be in memory/flash before the image is verified
+    if (_CompleteWrites(pSession, pSequenceNumber) != 0)
+    {
+        return FIRMWARE_UPDATE_STATUS_ERROR_WRITE;
+    }
+
+#if CFU_RESUMABLE_TRANSFER
+    // Whatever the outcome, the image is not resumed any more. A resume point
+    // that could not be cleared is caught by the CRC check if it is used.
+    _ClearCheckpoint(pSession);
+
+#endif
+    // Each component image should have an embedded CRC in the 
+    // downloaded image. Get the CRC offset for this particular component
+    // image. 
+    // Developer TODO- provide implementation of these helper functions
+    //                 that have a priori knowledge of crc/image
+    if (pRegistration)
+    {
+        getCrcOffsetResult = _ComponentGetCrcOffset(pRegistration, &crcOffset);
+    }
+
+    if (!MCU_SUCCESS(getCrcOffsetResult))
+    {
+        // Error retrieving crc offset
+        status = FIRMWARE_UPDATE_STATUS_ERROR_INVALID;
+    }
+    else if (getCrcOffsetResult != MCU_STATUS_CFU_CRC_CHECK_NOT_REQUIRED)
+    {
+        // CRC check required
+        TIMING_START(start);
+        status = _VerifyImageCrc(pSession, crcOffset, componentId);
+        TIMING_STOP(pSession, CFU_TIMING_PHASE_CRC, start);
+
+        if (status != FIRMWARE_UPDATE_STATUS_SUCCESS)
+        {
+            status = FIRMWARE_UPDATE_STATUS_ERROR_CRC;
+        }
+        else
+        {
+            //Successfully validated CRC
+            
+            //Perform any other image verification here
+            //  ex. Signatures, cert, encryption/decryption etc
+
+            // Best practices require that this image be verified to have come 
+            // from a non-rogue entity. To accomplish this, the image should
+            // be authenticated by some sort of cryptographically safe mechanism.
+            // (ex. certificate verification, pub/private key signing etc)
+            // Developer TODO- provide implementation of this authentication 
+            //                 implementation for their FW image.
+            if (_AuthenticateImage(pSession) != 0)
+            {
+                status = FIRMWARE_UPDATE_STATUS_ERROR_SIGNATURE;
+            }
+        }
+    }
+    else
+    {
+        // Skipping CRC check 
+
+        // Best practices require that this image be verified to have come 
+        // from a non-rogue entity. To accomplish this, the image should
+        // be authenticated by some sort of cryptologically safe mechanism.
+        // (ex. certificate verification, pub/private key signing etc)
+        // Developer TODO- provide implementation of this authentification 
+        //                 implementation for their FW image.
+        if (_AuthenticateImage(pSession) != 0)
+        {
+            status = FIRMWARE_UPDATE_STATUS_ERROR_SIGNATURE;
+        }
+    }
+
+    if (status == FIRMWARE_UPDATE_STATUS_SUCCESS)
+    {
+        MCU_STATUS notifyResult;
+        TIMING_START(start);
+
+        notifyResult = _ComponentNotifySuccess(pRegistration, pSession->forceReset, 
+                            pSession->pStorage->Read, 
+                            s_readCompleteCallbacks[pSession - s_sessions]);
+        TIMING_STOP(pSession, CFU_TIMING_PHASE_NOTIFY, start);
+
+        if (MCU_SUCCESS(notifyResult))
+        {
+            // Final component specific step of image consumption has succeeded
+            // We have successfully completed a FW Image write, 
+            // For some components this maybe be the last step of image
+            // update -> the next line can be commented out.
+            // For components that employ two banks and do
+            // ping pong updates - you may have to notify the 
+            // CFU code that a bank swap is pending. This will ensure
+            // that the CFU engine will not accept another image
+            // until the swap occurs. 
+            s_bankSwapPending = TRUE;
+#if CFU_VERSION_CACHE
+            // Components that switch to the new image right away report its
+            // version from now on.
+            _RefreshVersionCache(_ComponentIndex(pSession->activeComponentId) - 1);
+#endif
+        }
+        else
+        {
+            // Final component specific step of image consumption has failed
+            status = FIRMWARE_UPDATE_STATUS_ERROR_COMPLETE;
+        }
+    }
+
+    return status;
+}
+
+#if CFU_BACKGROUND_VERIFY
+//******************************************************************************
+//
+// _EndVerification - Record the result of a background verification and
+//                    send it to a host waiting with NOTIFY_ON_READY.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      UINT8 status - FIRMWARE_UPDATE_STATUS_xxx of the image.
+//
+//******************************************************************************
+static void _EndVerification(CURRENT_OFFER_INFO* pSession, UINT8 status)
+{
+    FWUPDATE_NOTIFY_OFFER_RESPONSE response;
+
+    pSession->verifyPending = FALSE;
+    pSession->verifyDone = TRUE;
+    pSession->verifyStatus = status;
+
+    if (pSession->notifyPending)
+    {
+        pSession->notifyPending = FALSE;
+
+        memset(&response, 0, sizeof (FWUPDATE_NOTIFY_OFFER_RESPONSE));
+
+        response.verifyStatus = status;
+        response.componentId = pSession->activeComponentId;
+        response.status = FIRMWARE_UPDATE_OFFER_COMMAND_READY;
+        response.token = pSession->notifyToken;
+        ICompFwUpdateBspSendOfferResponse((UINT8*)&response, sizeof (response));
+    }
+}
+
+//******************************************************************************
+//
+// _NotifyOnReady - Answer a NOTIFY_ON_READY offer with the result of the
+//                  background verification of a component. While it is
+//                  still running the response is deferred and sent by
+//                  _EndVerification; a later NOTIFY_ON_READY replaces it.
+//                  The host opted in to that by setting backgroundVerify in
+//                  its offer.
+//
+// Input Parameters
+//      FWUPDATE_NOTIFY_OFFER_COMMAND* pCommand - The command to process.
+//      FWUPDATE_NOTIFY_OFFER_RESPONSE* pResponse - The response to populate.
+//
+//******************************************************************************
+static void _NotifyOnReady(FWUPDATE_NOTIFY_OFFER_COMMAND* pCommand, FWUPDATE_NOTIFY_OFFER_RESPONSE* pResponse)
+{
+    UINT8 componentId = pCommand->componentInfo.componentId;
+    CURRENT_OFFER_INFO* pSession = NULL;
+    UINT8 sessionId;
+
+    for (sessionId = 0; sessionId < CFU_MAX_SESSIONS; sessionId++)
+    {
+        if ((s_sessions[sessionId].activeComponentId == componentId) &&
+            (s_sessions[sessionId].verifyPending || s_sessions[sessionId].verifyDone))
+        {
+            pSession = &s_sessions[sessionId];
+        }
+    }
+
+    memset(pResponse, 0, sizeof (FWUPDATE_NOTIFY_OFFER_RESPONSE));
+
+    pResponse->componentId = componentId;
+    pResponse->token = pCommand->componentInfo.token;
+
+    if (pSession && pSession->verifyPending)
+    {
+        pSession->notifyPending = TRUE;
+        pSession->notifyToken = pCommand->componentInfo.token;
+        pResponse->status = FIRMWARE_UPDATE_OFFER_DEFERRED;
+        return;
+    }
+
+    // No image of the component has been verified in the background
+    pResponse->verifyStatus = pSession ? pSession->verifyStatus : 
+                                         FIRMWARE_UPDATE_STATUS_ERROR_NO_OFFER;
+    pResponse->status = FIRMWARE_UPDATE_OFFER_COMMAND_READY;
+}
+#endif
+
+#if CFU_OFFER_LIST
+//******************************************************************************
+//
+// _EvaluateOfferList - Process the offers of a list that has ended, most
+//                      preferred first, and send each decision to the host.
+//                      Once an offer is accepted, later offers in the same
+//                      session are answered with FIRMWARE_UPDATE_OFFER_BUSY
+//                      and offered again after that update.
+//
+//******************************************************************************
+static void _EvaluateOfferList(void)
+{
+    UINT8 order[CFU_OFFER_LIST_MAX];
+    UINT8 rank[CFU_OFFER_LIST_MAX];
+    UINT8 i;
+    UINT8 j;
+
+    // Components are preferred in the order they were registered, those
+    // that are not registered come last. The sort is stable, so offers for
+    // the same component keep the order the host sent them in.
+    for (i = 0; i < s_offerListCount; i++)
+    {
+        UINT8 index = _ComponentIndex(s_offerList[i].componentInfo.componentId);
+
+        rank[i] = index ? index : MAX_UINT8;
+
+        for (j = i; (j > 0) && (rank[order[j - 1]] > rank[i]); j--)
+        {
+            order[j] = order[j - 1];
+        }
+        order[j] = i;
+    }
+
+    for (i = 0; i < s_offerListCount; i++)
+    {
+        FWUPDATE_OFFER_COMMAND* pOffer = &s_offerList[order[i]];
+        FWUPDATE_OFFER_RESPONSE response;
+
+        // Left as is for a component that is not registered
+        memset(&response, 0, sizeof (FWUPDATE_OFFER_RESPONSE));
+
+        response.status = FIRMWARE_UPDATE_OFFER_REJECT;
+        response.rejectReasonCode = FIRMWARE_OFFER_REJECT_INV_MCU;
+        response.token = pOffer->componentInfo.token;
+
+        ProcessCFWUOffer(pOffer, &response);
+
+        response.componentId = pOffer->componentInfo.componentId;
+        ICompFwUpdateBspSendOfferResponse((UINT8*)&response, sizeof (response));
+    }
+}
+
+//******************************************************************************
+//
+// _ProcessOfferInfo - Process an info only offer. OFFER_INFO_START_OFFER_LIST
+//                     starts buffering offers and OFFER_INFO_END_OFFER_LIST
+//                     evaluates them; its own response follows the
+//                     decisions.
+//
+// Input Parameters
+//      FWUPDATE_OFFER_INFO_ONLY_COMMAND* pCommand - The command to process.
+//      FWUPDATE_OFFER_RESPONSE* pResponse - The response to populate.
+//
+//******************************************************************************
+static void _ProcessOfferInfo(FWUPDATE_OFFER_INFO_ONLY_COMMAND* pCommand, FWUPDATE_OFFER_RESPONSE* pResponse)
+{
+    UINT8 infoCode = pCommand->componentInfo.infoCode;
+    BOOL endOfList = s_offerListActive && (infoCode == OFFER_INFO_END_OFFER_LIST);
+
+    // A new list or transaction drops a list that was not ended. The list is
+    // closed before it is evaluated so that its offers are processed.
+    s_offerListActive = (infoCode == OFFER_INFO_START_OFFER_LIST);
+
+    if (endOfList)
+    {
+        _EvaluateOfferList();
+    }
+
+    s_offerListCount = 0;
+
+    memset(pResponse, 0, sizeof (FWUPDATE_OFFER_RESPONSE));
+
+    pResponse->status = FIRMWARE_UPDATE_OFFER_COMMAND_READY;
+    pResponse->token = pCommand->componentInfo.token;
+}
+#endif
+
+#if CFU_RESUMABLE_TRANSFER
+//******************************************************************************
+//
+// _LoadCheckpoint - Load the stored resume point of a component and check
+//                   that it belongs to the given image version.
+//
+// Input Parameters
+//      CFU_CHECKPOINT* pCheckpoint - Receives the resume point.
+//      UINT8 componentId - The component.
+//      UINT32 version - Version of the image to resume.
+//
+// Return
+//      TRUE if the image can be resumed from *pCheckpoint.
+//
+//******************************************************************************
+static BOOL _LoadCheckpoint(CFU_CHECKPOINT* pCheckpoint, UINT8 componentId, UINT32 version)
+{
+    if (ICompFwUpdateBspReadCheckpoint(pCheckpoint, componentId) != 0)
+    {
+        return FALSE;
+    }
+
+    return (pCheckpoint->version != 0) &&
+           (pCheckpoint->version == version) &&
+           (pCheckpoint->componentId == componentId);
+}
+
+//******************************************************************************
+//
+// _ClearCheckpoint - Store that the active component has no resume point.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//
+// Return
+//      0 on success.
+//
+//******************************************************************************
+static UINT32 _ClearCheckpoint(CURRENT_OFFER_INFO* pSession)
+{
+    pSession->checkpoint.version = 0;
+
+    return ICompFwUpdateBspWriteCheckpoint(&pSession->checkpoint,
+                                           pSession->activeComponentId);
+}
+
+//******************************************************************************
+//
+// _UpdateCheckpoint - Make a block the new resume point once it ends at
+//      least CFU_CHECKPOINT_INTERVAL bytes past the last one. Every block up
+//      to and including it must have been received. A component that
+//      coalesces writes only gets resume points at an erase sector boundary
+//      and with lazy erase, see below.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      FWUPDATE_CONTENT_COMMAND* pCommand - The block.
+//      UINT16* pSequenceNumber - On failure, updated to the sequence number
+//              of the first block whose data could not be written.
+//
+// Return
+//      0 on success.
+//
+//******************************************************************************
+static UINT32 _UpdateCheckpoint(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand, UINT16* pSequenceNumber)
+{
+    UINT32 address = pCommand->address + pCommand->length;
+
+#if CFU_ENCODED_PAYLOAD
+    // Encoded blocks are addressed within the encoded stream, not the image
+    if (pSession->payloadEncoding != PAYLOAD_ENCODING_NONE)
+    {
+        return 0;
+    }
+
+#endif
+    if ((address < pSession->checkpoint.address) ||
+        ((address - pSession->checkpoint.address) < CFU_CHECKPOINT_INTERVAL))
+    {
+        return 0;
+    }
+
+    // A page may only be programmed once between erases. Flushing a partial
+    // page here would program the rest of it a second time, and so would
+    // sending the blocks after the resume point again. The resume point is
+    // therefore kept where the write buffer is empty at the start of a
+    // sector, which lazy erase erases again after a resume.
+    if (_CoalescesWrites(pSession->pActiveComponent))
+    {
+        UINT32 sectorSize = 0;
+
+#if CFU_LAZY_ERASE
+        sectorSize = pSession->pActiveComponent->eraseSectorSize;
+#endif
+#if CFU_WRITE_COALESCING
+        if (pSession->writeBufferLength != 0)
+        {
+            return 0;
+        }
+#endif
+        if ((sectorSize == 0) || ((address & (sectorSize - 1)) != 0))
+        {
+            return 0;
+        }
+    }
+
+    // Only programmed data may be covered by the resume point. The write
+    // buffer is empty, so this only waits for whole pages.
+    if (_CompleteWrites(pSession, pSequenceNumber) != 0)
+    {
+        return 1;
+    }
+
+    pSession->checkpoint.version = pSession->offerVersion;
+    pSession->checkpoint.address = address;
+    pSession->checkpoint.sequenceNumber = pCommand->sequenceNumber;
+
+    // A resume point that could not be stored only means the host has to
+    // start over after an interruption.
+    ICompFwUpdateBspWriteCheckpoint(&pSession->checkpoint, pSession->activeComponentId);
+
+    return 0;
+}
+
+//******************************************************************************
+//
+// _ResumeImage - Continue staging an image from the stored resume point
+//      instead of preparing the component again. The block must be the one
+//      following the resume point; it is then processed like any other.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      FWUPDATE_CONTENT_COMMAND* pCommand - The first block after the offer.
+//
+// Return
+//      0 on success.
+//
+//******************************************************************************
+static UINT32 _ResumeImage(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand)
+{
+    UINT16 sequenceNumber = pCommand->sequenceNumber;
+
+    pSession->resumePending = FALSE;
+
+    if (sequenceNumber != (UINT16)(pSession->checkpoint.sequenceNumber + 1))
+    {
+        return 1;
+    }
+
+#if CFU_ASYNC_WRITE
+    // Drop a page left over from an abandoned update
+    _CheckAsyncWrite(pSession, TRUE, &sequenceNumber);
+#endif
+#if CFU_STREAMING_CRC
+    // The blocks before the resume point were not seen by this session, so
+    // the whole image is checked with ICompFwUpdateBspCalcCRC.
+    _StartStreamingCrc(pSession, pCommand->address);
+    pSession->crcStreamValid = FALSE;
+#endif
+#if CFU_STREAMING_DIGEST
+    // Nor could they be digested
+    pSession->digestStreamValid = FALSE;
+#endif
+#if CFU_WRITE_COALESCING
+    pSession->writeBufferLength = 0;
+#endif
+#if CFU_WRITE_LIST
+    _ResetWriteList(pSession);
+#endif
+#if CFU_LAZY_ERASE
+    _StartLazyErase(pSession);
+
+    // Sectors below the resume point were erased before they were written
+    if (pSession->pActiveComponent->eraseSectorSize != 0)
+    {
+        UINT32 sector;
+
+        for (sector = 0;
+             (sector < (CFU_ERASE_BITMAP_BYTES * 8)) &&
+             ((sector << pSession->eraseSectorShift) < pSession->checkpoint.address);
+             sector++)
+        {
+            pSession->erasedSectors[sector >> 3] |= (UINT8)(1u << (sector & 7));
+        }
+    }
+#endif
+#if CFU_CONTENT_WINDOW_MAX
+    pSession->windowStarted = TRUE;
+    pSession->lastBlockReceived = FALSE;
+    pSession->ackSequenceNumber = pSession->checkpoint.sequenceNumber;
+    pSession->selectiveAckMask = 0;
+#endif
+
+    return 0;
+}
+
+//******************************************************************************
+//
+// _GetResumePoint - Answer a CFU_SPECIAL_OFFER_GET_RESUME_POINT offer with
+//      the stored resume point of a component, if it matches the version.
+//
+// Input Parameters
+//      FWUPDATE_RESUME_OFFER_COMMAND* pCommand - The special offer.
+//      FWUPDATE_RESUME_OFFER_RESPONSE* pResponse - The response to populate.
+//
+//******************************************************************************
+static void _GetResumePoint(FWUPDATE_RESUME_OFFER_COMMAND* pCommand, FWUPDATE_RESUME_OFFER_RESPONSE* pResponse)
+{
+    UINT8 componentId = pCommand->componentInfo.componentId;
+    CFU_CHECKPOINT checkpoint;
+
+    memset(pResponse, 0, sizeof(FWUPDATE_RESUME_OFFER_RESPONSE));
+    pResponse->token = pCommand->componentInfo.token;
+
+    if (_FindComponent(componentId) &&
+        _LoadCheckpoint(&checkpoint, componentId, pCommand->version))
+    {
+        pResponse->status = FIRMWARE_UPDATE_OFFER_COMMAND_READY;
+        pResponse->sequenceNumber = checkpoint.sequenceNumber;
+        pResponse->address = checkpoint.address;
+    }
+    else
+    {
+        pResponse->status = FIRMWARE_UPDATE_OFFER_REJECT;
+        pResponse->rejectReasonCode = FIRMWARE_OFFER_REJECT_MISMATCH;
+    }
+}
+#endif
+
+#if CFU_CONTENT_WINDOW_MAX
+//******************************************************************************
+//
+// _ProcessWindowedContent - Process a content block when the host has
+//      negotiated a content window. Up to contentWindow blocks past the
+//      cumulative acknowledgement are accepted in any order. Blocks that
+//      were already received are acknowledged again without being written,
+//      and a block beyond the window ends the update. A first block starts
+//      the image over. The image is finished once every block up to the
+//      last one is in.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      FWUPDATE_CONTENT_COMMAND* pCommand - The content block.
+//      UINT16* pSequenceNumber - Sequence number to report in the response.
+//
+// Return
+//      FIRMWARE_UPDATE_STATUS_xxx
+//
+//******************************************************************************
+static UINT8 _ProcessWindowedContent(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand, UINT16* pSequenceNumber)
+{
+    UINT8 status = FIRMWARE_UPDATE_STATUS_SUCCESS;
+    UINT16 delta;
+    UINT32 bit;
+
+    // A first block sent again, e.g. because its response was lost,
+    // prepares the component again as it would without a window.
+    if (!pSession->windowStarted || (pCommand->flags & FIRMWARE_UPDATE_FLAG_FIRST_BLOCK))
+    {
+        // The first block is sent on its own; the window opens once it 
+        // has been acknowledged.
+        if (!(pCommand->flags & FIRMWARE_UPDATE_FLAG_FIRST_BLOCK))
+        {
+            return FIRMWARE_UPDATE_STATUS_ERROR_INVALID;
+        }
+
+        status = _StartImage(pSession, pCommand, pSequenceNumber);
+
+        if (status == FIRMWARE_UPDATE_STATUS_SUCCESS)
+        {
+            pSession->windowStarted = TRUE;
+            pSession->lastBlockReceived = FALSE;
+            pSession->ackSequenceNumber = pCommand->sequenceNumber;
+            pSession->selectiveAckMask = 0;
+        }
+
+        return status;
+    }
+
+    delta = (UINT16)(pCommand->sequenceNumber - pSession->ackSequenceNumber);
+
+    if ((delta == 0) || (delta & 0x8000))
+    {
+        // Already acknowledged, e.g. sent again after its response was lost
+        return FIRMWARE_UPDATE_STATUS_SUCCESS;
+    }
+
+    if (delta > pSession->contentWindow)
+    {
+        // The host has more blocks outstanding than it was granted
+        return FIRMWARE_UPDATE_STATUS_ERROR_INVALID;
+    }
+
+    bit = 1UL << (delta - 1);
+
+    if (pSession->selectiveAckMask & bit)
+    {
+        // Duplicate of a block received out of order
+        return FIRMWARE_UPDATE_STATUS_SUCCESS;
+    }
+
+    if (_WriteBlock(pSession, pCommand, pSequenceNumber) != 0)
+    {
+        return FIRMWARE_UPDATE_STATUS_ERROR_WRITE;
+    }
+
+    pSession->selectiveAckMask |= bit;
+
+    if (pCommand->flags & FIRMWARE_UPDATE_FLAG_LAST_BLOCK)
+    {
+        pSession->lastBlockReceived = TRUE;
+        pSession->lastSequenceNumber = pCommand->sequenceNumber;
+    }
+
+    while (pSession->selectiveAckMask & 1)
+    {
+        pSession->ackSequenceNumber++;
+        pSession->selectiveAckMask >>= 1;
+    }
+
+    if (pSession->lastBlockReceived && 
+        (pSession->ackSequenceNumber == pSession->lastSequenceNumber))
+    {
+        pSession->lastBlockReceived = FALSE;
+        status = _FinishImage(pSession, pSequenceNumber);
+    }
+#if CFU_RESUMABLE_TRANSFER
+    else if (pSession->ackSequenceNumber == pCommand->sequenceNumber)
+    {
+        // Every block up to this one is in, so it can be a resume point
+        if (_UpdateCheckpoint(pSession, pCommand, pSequenceNumber) != 0)
+        {
+            status = FIRMWARE_UPDATE_STATUS_ERROR_WRITE;
+        }
+    }
+#endif
+
+    return status;
+}
+#endif
+
+#if CFU_UNORDERED_CONTENT
+//******************************************************************************
+//
+// _ProcessUnorderedContent - Process a content block when the host has
+//      negotiated out of order content. After the first block, which prepares
+//      the component, blocks are accepted in any order. All of them but the
+//      last must be as long as the first one and start at a multiple of its
+//      length from it. Blocks that were already received are acknowledged
+//      again without being written. The image is finished once every block
+//      up to the last one is in, whichever block that happens to be.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session.
+//      FWUPDATE_CONTENT_COMMAND* pCommand - The content block.
+//      UINT16* pSequenceNumber - Sequence number to report in the response.
+//
+// Return
+//      FIRMWARE_UPDATE_STATUS_xxx
+//
+//******************************************************************************
+static UINT8 _ProcessUnorderedContent(CURRENT_OFFER_INFO* pSession, FWUPDATE_CONTENT_COMMAND* pCommand, UINT16* pSequenceNumber)
+{
+    UINT8 status = FIRMWARE_UPDATE_STATUS_SUCCESS;
+    BOOL lastBlock = (pCommand->flags & FIRMWARE_UPDATE_FLAG_LAST_BLOCK) != 0;
+    UINT32 offset;
+    UINT32 blockIndex;
+    UINT8 bit;
+
+    if (!pSession->unorderedStarted)
+    {
+        // The first block is sent on its own and sets the block length
+        if (!(pCommand->flags & FIRMWARE_UPDATE_FLAG_FIRST_BLOCK) || (pCommand->length == 0))
+        {
+            return FIRMWARE_UPDATE_STATUS_ERROR_INVALID;
+        }
+
+        status = _StartImage(pSession, pCommand, pSequenceNumber);
+
+        if (status == FIRMWARE_UPDATE_STATUS_SUCCESS)
+        {
+            pSession->unorderedStarted = TRUE;
+            pSession->receiveBase = pCommand->address;
+            pSession->receiveBlockLength = pCommand->length;
+            pSession->receivedCount = 1;
+            pSession->highestBlockIndex = 0;
+            pSession->lastBlockIndex = MAX_UINT16;
+            memset(pSession->receivedBlocks, 0, sizeof(pSession->receivedBlocks));
+            pSession->receivedBlocks[0] = 1;
+
+            if (lastBlock)
+            {
+                status = _FinishImage(pSession, pSequenceNumber);
+            }
+        }
+
+        return status;
+    }
+
+    offset = pCommand->address - pSession->receiveBase;
+    blockIndex = offset / pSession->receiveBlockLength;
+
+    if ((pCommand->address < pSession->receiveBase) || 
+        ((offset % pSession->receiveBlockLength) != 0) ||
+        (blockIndex >= (CFU_RECEIVE_BITMAP_BYTES * 8)) ||
+        (blockIndex > pSession->lastBlockIndex))
+    {
+        // Not where a block of this image can start
+        return FIRMWARE_UPDATE_STATUS_ERROR_INVALID_ADDR;
+    }
+
+    if ((pCommand->length > pSession->receiveBlockLength) ||
+        (!lastBlock && (pCommand->length != pSession->receiveBlockLength)) ||
+        (lastBlock && (blockIndex < pSession->highestBlockIndex)))
+    {
+        // Only the last block may be short, and no block may follow it
+        return FIRMWARE_UPDATE_STATUS_ERROR_INVALID;
+    }
+
+    bit = (UINT8)(1u << (blockIndex & 7));
+
+    if (pSession->receivedBlocks[blockIndex >> 3] & bit)
+    {
+        // Sent again because its response was lost
+        return FIRMWARE_UPDATE_STATUS_SUCCESS;
+    }
+
+    if (_WriteBlock(pSession, pCommand, pSequenceNumber) != 0)
+    {
+        return FIRMWARE_UPDATE_STATUS_ERROR_WRITE;
+    }
+
+    pSession->receivedBlocks[blockIndex >> 3] |= bit;
+    pSession->receivedCount++;
+
+    if (blockIndex > pSession->highestBlockIndex)
+    {
+        pSession->highestBlockIndex = (UINT16)blockIndex;
+    }
+
+    if (lastBlock)
+    {
+        pSession->lastBlockIndex = (UINT16)blockIndex;
+    }
+
+    if ((pSession->lastBlockIndex != MAX_UINT16) &&
+        (pSession->receivedCount == (UINT32)pSession->lastBlockIndex + 1))
+    {
+        status = _FinishImage(pSession, pSequenceNumber);
+    }
+
+    return status;
+}
+#endif
+
+//****************************************************************************
+//
+//                              GLOBAL FUNCTIONS
+//
+//****************************************************************************
+
+//****************************************************************************
+//
+// FirmwareUpdateInit - Initialization that needs to occur when its 
+// task starts up
+// 
+//    NOTE: This function must be called at system start up
+//          Calling it again puts the engine back in its start up state.
+//
+//****************************************************************************
+UINT32 FirmwareUpdateInit(void)
+{
+    memset(s_sessions, 0, sizeof(s_sessions));
+    s_bankSwapPending = FALSE;
+    s_fwVersionPage = 0;
+#if CFU_OFFER_LIST
+    s_offerListActive = FALSE;
+    s_offerListCount = 0;
+#endif
+#if CFU_UNORDERED_CONTENT && CFU_RANGE_COMPARE
+    memset(s_rangesMatched, 0, sizeof(s_rangesMatched));
+#endif
+
+    if (s_updateTimer == 0)
+    {
+        s_updateTimer = BSP_Timer_Create( _UpdateTimerCallback, 
+                                          MAX_FW_UPDATE_TIME_FAIL_SAFE_MS);
+    }
+    BSP_Timer_Stop(s_updateTimer);
+#if CFU_INACTIVITY_TIMEOUT_MS
+    if (s_inactivityTimer == 0)
+    {
+        s_inactivityTimer = BSP_Timer_Create( _InactivityTimerCallback, 
+                                              CFU_INACTIVITY_TICK_MS);
+    }
+    BSP_Timer_Stop(s_inactivityTimer);
+#endif
+#if CFU_VERSION_CACHE
+    {
+        UINT8 index;
+
+        // A pending bank swap has happened by the time the engine is restarted.
+        for (index = 0; index < COMPONENT_COUNT; index++)
+        {
+            _RefreshVersionCache(index);
+        }
+    }
+#endif
+    return 0;
+}
+
+//****************************************************************************
+//
+// FirmwareUpdateBackgroundTask - Verify the images whose last block has
+//      been answered with FIRMWARE_UPDATE_STATUS_ERROR_PENDING.
+//
+//    NOTE: Call this after ICompFwUpdateBspSignalVerifyPending, from the
+//          task that calls the ProcessCFWUxxx functions or another one that
+//          never runs at the same time as them.
+//
+//****************************************************************************
+void FirmwareUpdateBackgroundTask(void)
+{
+#if CFU_BACKGROUND_VERIFY
+    UINT8 sessionId;
+
+    for (sessionId = 0; sessionId < CFU_MAX_SESSIONS; sessionId++)
+    {
+        CURRENT_OFFER_INFO* pSession = &s_sessions[sessionId];
+        // The last block has been answered, a write error has no block to
+        // report.
+        UINT16 sequenceNumber = 0;
+        UINT8 status;
+
+        if (!pSession->verifyPending)
+        {
+            continue;
+        }
+
+        if (pSession->updateInProgress)
+        {
+            status = _FinishImage(pSession, &sequenceNumber);
+
+            if (status != FIRMWARE_UPDATE_STATUS_SUCCESS)
+            {
+                pSession->updateInProgress = FALSE;
+            }
+        }
+        else
+        {
+            // Ended by the fail safe timer in the meantime
+            status = FIRMWARE_UPDATE_STATUS_ERROR_NO_OFFER;
+        }
+
+        _EndVerification(pSession, status);
+    }
+#endif
+}
+
+//******************************************************************************
+//
+// _BuildContentResponse - Fill in every field of a content response.
+//
+// Input Parameters
+//      CURRENT_OFFER_INFO* pSession - The update session, NULL if the
+//              command did not name a valid one.
+//      UINT16 sequenceNumber - Sequence number to report.
+//      UINT8 status - FIRMWARE_UPDATE_STATUS_xxx
+//      FWUPDATE_CONTENT_RESPONSE* pResponse - The response to populate.
+//
+//******************************************************************************
+static void _BuildContentResponse(CURRENT_OFFER_INFO* pSession, UINT16 sequenceNumber, UINT8 status, FWUPDATE_CONTENT_RESPONSE* pResponse)
+{
+    pResponse->sequenceNumber = sequenceNumber;
+    pResponse->ackSequenceNumber = 0;
+    pResponse->status = status;
+    pResponse->reserved1[0] = 0;
+    pResponse->reserved1[1] = 0;
+    pResponse->reserved1[2] = 0;
+    pResponse->selectiveAckMask = 0;
+    pResponse->reserved2 = 0;
+#if CFU_CONTENT_WINDOW_MAX
+    if (pSession && (pSession->contentWindow != 0))
+    {
+        pResponse->ackSequenceNumber = pSession->ackSequenceNumber;
+        pResponse->selectiveAckMask = pSession->selectiveAckMask;
+    }
+#endif
+}
+
+//******************************************************************************
+//
+// _ProcessContent - Process a content command and populate its response.
+//
+// Input Parameters
+//      FWUPDATE_CONTENT_COMMAND* pCommand - The command to process.
+//      UINT8 status - FIRMWARE_UPDATE_STATUS_SUCCESS, or the error that the
+//              command already failed with.
+//      FWUPDATE_CONTENT_RESPONSE* pResponse - The response to populate. It
+//              may share the buffer of the command.
+//
+//******************************************************************************
+static void _ProcessContent(FWUPDATE_CONTENT_COMMAND* pCommand, UINT8 status, FWUPDATE_CONTENT_RESPONSE* pResponse)
+{
+    UINT16 sequenceNumber = pCommand->sequenceNumber;
+    UINT8 sessionId = pCommand->flags & FIRMWARE_UPDATE_FLAG_SESSION_MASK;
+    CURRENT_OFFER_INFO* pSession = NULL;
+
+#if CFU_RANGE_COMPARE
+    if (pCommand->flags & FIRMWARE_UPDATE_FLAG_COMPARE)
+    {
+        _CompareContent(pCommand, status, pResponse);
+        return;
+    }
+
+#endif
+    if (sessionId < CFU_MAX_SESSIONS)
+    {
+        pSession = &s_sessions[sessionId];
+#if CFU_INACTIVITY_TIMEOUT_MS
+        // The host is still there, re-arm the inactivity timeout
+        pSession->idleMs = 0;
+#endif
+    }
+
+    if (status != FIRMWARE_UPDATE_STATUS_SUCCESS)
+    {
+        // Malformed command, it ends the update like any other error
+    }
+    else if (!pSession || !pSession->updateInProgress)
+    {
+        // No offer has been accepted, or the update has already ended
+        status = FIRMWARE_UPDATE_STATUS_ERROR_NO_OFFER;
+    }
+#if CFU_BACKGROUND_VERIFY
+    else if (pSession->verifyPending)
+    {
+        // The image is complete, nothing is written while it is verified
+        status = FIRMWARE_UPDATE_STATUS_ERROR_PENDING;
+    }
+#endif
+#if CFU_REGION_CHECK
+    else if (!_IsWritableBlock(pSession, pCommand))
+    {
+        // Rejected before anything is written or erased
+        status = FIRMWARE_UPDATE_STATUS_ERROR_INVALID_ADDR;
+    }
+#endif
+#if CFU_RESUMABLE_TRANSFER
+    else if (pSession->resumePending &&
+             !(pCommand->flags & FIRMWARE_UPDATE_FLAG_FIRST_BLOCK) &&
+             (_ResumeImage(pSession, pCommand) != 0))
+    {
+        // The first block does not follow the resume point
+        status = FIRMWARE_UPDATE_STATUS_ERROR_INVALID;
+    }
+#endif
+#if CFU_UNORDERED_CONTENT
+    else if (pSession->unorderedContent)
+    {
+        status = _ProcessUnorderedContent(pSession, pCommand, &sequenceNumber);
+    }
+#endif
+#if CFU_CONTENT_WINDOW_MAX
+    else if (pSession->contentWindow != 0)
+    {
+        status = _ProcessWindowedContent(pSession, pCommand, &sequenceNumber);
+    }
+#endif
+    else if (pCommand->flags & FIRMWARE_UPDATE_FLAG_FIRST_BLOCK)
+    {
+        status = _StartImage(pSession, pCommand, &sequenceNumber);
+    }
+    else if (pCommand->flags & FIRMWARE_UPDATE_FLAG_LAST_BLOCK)
+    {
+        if (_WriteBlock(pSession, pCommand, &sequenceNumber) == 0)
+        {
+            status = _FinishImage(pSession, &sequenceNumber);
+        }
+        else
+        {
+            status = FIRMWARE_UPDATE_STATUS_ERROR_WRITE;
+        }
+    }
+    else
+    {
+        if (_WriteBlock(pSession, pCommand, &sequenceNumber) != 0)
+        {
+            status = FIRMWARE_UPDATE_STATUS_ERROR_WRITE;
+        }
+#if CFU_RESUMABLE_TRANSFER
+        else if (_UpdateCheckpoint(pSession, pCommand, &sequenceNumber) != 0)
+        {
+            status = FIRMWARE_UPDATE_STATUS_ERROR_WRITE;
+        }
+#endif
+    }
+
+    // An image being verified in the background keeps its session
+    if ((status != FIRMWARE_UPDATE_STATUS_SUCCESS) && 
+        (status != FIRMWARE_UPDATE_STATUS_ERROR_PENDING) && pSession)
+    {
+        pSession->updateInProgress = FALSE;
+    }
+
+    _BuildContentResponse(pSession, sequenceNumber, status, pResponse);
+}
+
+//******************************************************************************
+//
+// ProcessCFWUContent - Process the content component firmware update command.
+//                      NOTE: this function is non reentrant - only to be called
+//                            from single thread. If this is not the case
+//                            for your implementation - extra care must be
+//                            made for thread safety.
+// Input Parameters
+//      FWUPDATE_CONTENT_COMMAND* pCommand - The command to process.
+//      FWUPDATE_CONTENT_RESPONSE* pResponse - The response to populate.
+//
+//******************************************************************************
+void ProcessCFWUContent(FWUPDATE_CONTENT_COMMAND* pCommand, 
+        FWUPDATE_CONTENT_RESPONSE* pResponse)
+{
+    _ProcessContent(pCommand, FIRMWARE_UPDATE_STATUS_SUCCESS, pResponse);
+}
+
+//******************************************************************************
+//
+// ProcessCFWUContentBuffer - Process a content command in place in the
+//      receive buffer of the transport, and build the response directly in
+//      its transmit buffer. The block data is handed to the BSP from the
+//      receive buffer, so no FWUPDATE_CONTENT_COMMAND has to be allocated
+//      or copied. The buffers may be the same one.
+//                      NOTE: this function is non reentrant - only to be called
+//                            from single thread. If this is not the case
+//                            for your implementation - extra care must be
+//                            made for thread safety.
+// Input Parameters
+//      UINT8* pReceive - The command: the content command header followed
+//              by its data, at any alignment.
+//      UINT16 receiveLength - Number of bytes received. Bytes following the
+//              data of the block, such as report padding, are ignored.
+//      UINT8* pTransmit - Receives the sizeof(FWUPDATE_CONTENT_RESPONSE)
+//              byte response.
+//
+//******************************************************************************
+void ProcessCFWUContentBuffer(UINT8* pReceive, UINT16 receiveLength, UINT8* pTransmit)
+{
+    // The command and response are packed, so their fields can be accessed
+    // at any alignment.
+    FWUPDATE_CONTENT_COMMAND* pCommand = (FWUPDATE_CONTENT_COMMAND*)pReceive;
+    FWUPDATE_CONTENT_RESPONSE* pResponse = (FWUPDATE_CONTENT_RESPONSE*)pTransmit;
+    UINT16 headerLength = offsetof(FWUPDATE_CONTENT_COMMAND, pData);
+
+    if (receiveLength < headerLength)
+    {
+        // Not even the header arrived, so there is no session to end
+        _BuildContentResponse(NULL, 0, FIRMWARE_UPDATE_STATUS_ERROR_INVALID, pResponse);
+    }
+    else if (pCommand->length > (receiveLength - headerLength))
+    {
+        _ProcessContent(pCommand, FIRMWARE_UPDATE_STATUS_ERROR_INVALID, pResponse);
+    }
+    else
+    {
+        _ProcessContent(pCommand, FIRMWARE_UPDATE_STATUS_SUCCESS, pResponse);
+    }
+}
+
+//******************************************************************************
+//
+// ProcessCFWUOffer - Process the offer component firmware update command.
+//                      NOTE: this function is non reentrant - only to be called
+//                            from single thread. If this is not the case
+//                            for your implementation - extra care must be
+//                            made for thread safety. 
+//
+// Input Parameters
+//      FWUPDATE_OFFER_COMMAND* pCommand - The command to process.
+//      FWUPDATE_OFFER_RESPONSE* pResponse - The response to populate.
+//
+//******************************************************************************
+void ProcessCFWUOffer(FWUPDATE_OFFER_COMMAND* pCommand, 
+                      FWUPDATE_OFFER_RESPONSE* pResponse)
+{
+
+    // A token is a user-software defined byte.  It's a signature
+    // that disambiguates one user-software conducting a CFU from
+    // another user-software programming conducting a CFU.  Elect
+    // a unique token byte in the user-software design.  The CFU
+    // implementation does not define tokens.
+    UINT8 token = pCommand->componentInfo.token;
+
+    UINT8 componentId = pCommand->componentInfo.componentId;
+
+    // Special and info only offers have no productInfo and use session 0.
+    UINT8 sessionId = (componentId < CFU_SPECIAL_OFFER_CMD) ?
+                      pCommand->productInfo.sessionId : 0;
+    CURRENT_OFFER_INFO* pSession = &s_sessions[0];
+
+    // The host is done reading versions, the next read starts at page 0
+    s_fwVersionPage = 0;
+
+    // An abort is what frees busy sessions, so it is handled first.
+    if ((componentId == CFU_SPECIAL_OFFER_CMD) &&
+        (((FWUPDATE_SPECIAL_OFFER_COMMAND*)pCommand)->componentInfo.commandCode == 
+                CFU_SPECIAL_OFFER_ABORT))
+    {
+        _AbortSessions(((FWUPDATE_ABORT_OFFER_COMMAND*)pCommand)->componentInfo.componentId);
+
+        memset(pResponse, 0, sizeof (FWUPDATE_OFFER_RESPONSE));
+
+        pResponse->status = FIRMWARE_UPDATE_OFFER_COMMAND_READY;
+        pResponse->token = token;
+        return;
+    }
+
+#if CFU_BACKGROUND_VERIFY
+    // The session being verified stays busy until the host is notified
+    if ((componentId == CFU_SPECIAL_OFFER_CMD) &&
+        (((FWUPDATE_SPECIAL_OFFER_COMMAND*)pCommand)->componentInfo.commandCode == 
+                CFU_SPECIAL_OFFER_NOTIFY_ON_READY))
+    {
+        _NotifyOnReady((FWUPDATE_NOTIFY_OFFER_COMMAND*)pCommand,
+                       (FWUPDATE_NOTIFY_OFFER_RESPONSE*)pResponse);
+        return;
+    }
+
+#endif
+#if CFU_OFFER_LIST
+    // Info only offers frame a list of offers, evaluated at its end
+    if (componentId == CFU_OFFER_METADATA_INFO_CMD)
+    {
+        _ProcessOfferInfo((FWUPDATE_OFFER_INFO_ONLY_COMMAND*)pCommand, pResponse);
+        return;
+    }
+
+    if (s_offerListActive && (componentId < CFU_SPECIAL_OFFER_CMD))
+    {
+        memset(pResponse, 0, sizeof (FWUPDATE_OFFER_RESPONSE));
+
+        if (s_offerListCount < CFU_OFFER_LIST_MAX)
+        {
+            s_offerList[s_offerListCount++] = *pCommand;
+            pResponse->status = FIRMWARE_UPDATE_OFFER_DEFERRED;
+        }
+        else
+        {
+            // The host offers it again once the list has been answered
+            pResponse->status = FIRMWARE_UPDATE_OFFER_BUSY;
+            pResponse->rejectReasonCode = FIRMWARE_UPDATE_OFFER_BUSY;
+        }
+
+        pResponse->token = token;
+        return;
+    }
+
+#endif
+    // The host asked for a session this firmware does not have.
+    // If this condition is detected, return immediately.
+    if (sessionId >= CFU_MAX_SESSIONS)
+    {
+        memset(pResponse, 0, sizeof (FWUPDATE_OFFER_RESPONSE));
+
+        pResponse->status = FIRMWARE_UPDATE_OFFER_REJECT;
+        pResponse->rejectReasonCode = FIRMWARE_OFFER_REJECT_INV_MCU;
+        pResponse->token = token;
+        return;
+    }
+
+    pSession = &s_sessions[sessionId];
+
+    // The last offer isn't completely processed.
+    // When the offer that was last offered in this session, or an offer
+    // for the same component in another session, still remains pending
+    // completion, the state is FIRMWARE_UPDATE_OFFER_BUSY. Special offers
+    // have no session of their own, so they are busy while any session is.
+    // If this condition is detected, return immediately.
+    if (pSession->updateInProgress ||
+        ((componentId < CFU_SPECIAL_OFFER_CMD) ? (_FindSession(componentId) != NULL) : 
+                                                 _IsUpdateInProgress()))
+    {
+        memset(pResponse, 0, sizeof (FWUPDATE_OFFER_RESPONSE));
+
+        pResponse->status = FIRMWARE_UPDATE_OFFER_BUSY;
+        pResponse->rejectReasonCode = FIRMWARE_UPDATE_OFFER_BUSY;
+        pResponse->token = token;
+        return;
+    }
+
+    // Or, if intent is to retrieve the status of a special offer
+    // If this condition is detected, return immediately.
+    else if (componentId == CFU_SPECIAL_OFFER_CMD)
+    {
+        FWUPDATE_SPECIAL_OFFER_COMMAND* pSpecialCommand = 
+            (FWUPDATE_SPECIAL_OFFER_COMMAND*)pCommand;
+        if (pSpecialCommand->componentInfo.commandCode == CFU_SPECIAL_OFFER_GET_STATUS)
+        {
+            memset(pResponse, 0, sizeof (FWUPDATE_OFFER_RESPONSE));
+
+            pResponse->status = FIRMWARE_UPDATE_OFFER_COMMAND_READY;
+            pResponse->token = token;
+            return;
+        }
+#if CFU_RESUMABLE_TRANSFER
+        else if (pSpecialCommand->componentInfo.commandCode == CFU_SPECIAL_OFFER_GET_RESUME_POINT)
+        {
+            _GetResumePoint((FWUPDATE_RESUME_OFFER_COMMAND*)pCommand,
+                            (FWUPDATE_RESUME_OFFER_RESPONSE*)pResponse);
+            return;
+        }
+#endif
+#if CFU_RANGE_COMPARE
+        else if (pSpecialCommand->componentInfo.commandCode == CFU_SPECIAL_OFFER_COMPARE_RANGES)
+        {
+            _CompareRanges((FWUPDATE_COMPARE_OFFER_COMMAND*)pCommand,
+                           (FWUPDATE_COMPARE_OFFER_RESPONSE*)pResponse);
+            return;
+        }
+#endif
+    }
+
+    // Or, if the MCU is in progress of swapping Bank 0 for Bank 1 (or vice versa)
+    // so the offer is rejected 
+    // If this condition is detected, return immediately.
+    else if (s_bankSwapPending)
+    {
+        memset(pResponse, 0, sizeof (FWUPDATE_OFFER_RESPONSE));
+
+        pResponse->status = FIRMWARE_UPDATE_OFFER_REJECT;
+        pResponse->rejectReasonCode = FIRMWARE_UPDATE_OFFER_SWAP_PENDING;
+        pResponse->token = token;
+        return;
+    }
+
+    // Else, continue processing the offer by inspecting the registration list.  
+    //    Each offer will specify whether or not to:
+    //        A) force a MCU reset after processing the offer content
+    //        B) ignore the version of the MCU Component Firmware when
+    //           analyzing this offers version.
+    //
+    //    Unless there was overriding flags via "force" or "ignore"
+    //    Then the offer is accepted and this notifies the other
+    //    user software to move towards the action of submitting Content.
+    // NOTE: it is assumed component registration has already been completed
+    //       before this function is called and that registration will not
+    //       change for the duration of the running image. If this is NOT
+    //       correct for your implementation - it is left up to the developer
+    //       to wrap the registration lookup below in a thread safe construct.
+    const COMPONENT_REGISTRATION* pRegistration = _FindComponent(componentId);
+
+    if (pRegistration)
+    {
+        BOOL forceReset = pCommand->componentInfo.forceImmediateReset;
+        BOOL ignoreVersion = pCommand->componentInfo.forceIgnoreVersion;
+        UINT8 payloadEncoding = PAYLOAD_ENCODING_NONE;
+        BOOL encodingSupported = TRUE;
+#if CFU_CONTENT_WINDOW_MAX
+        UINT8 contentWindow = pCommand->componentInfo.contentWindow;
+#endif
+#if CFU_UNORDERED_CONTENT
+        BOOL unorderedContent = pCommand->productInfo.unorderedContent;
+#endif
+#if CFU_BACKGROUND_VERIFY
+        BOOL backgroundVerify = pCommand->productInfo.backgroundVerify;
+#endif
+#if CFU_RESUMABLE_TRANSFER
+        UINT32 version = pCommand->version;
+#endif
+
+        if (pCommand->productInfo.deltaPayload)
+        {
+            payloadEncoding = PAYLOAD_ENCODING_DELTA;
+            encodingSupported = CFU_DELTA_PAYLOAD &&
+                ((pRegistration->flags & COMPONENT_FLAG_DELTA_PAYLOAD) != 0);
+        }
+
+        if (pCommand->productInfo.compressedPayload)
+        {
+            // A delta patch cannot be compressed as well
+            encodingSupported = CFU_COMPRESSED_PAYLOAD && 
+                (payloadEncoding == PAYLOAD_ENCODING_NONE) &&
+                ((pRegistration->flags & COMPONENT_FLAG_COMPRESSED_PAYLOAD) != 0);
+            payloadEncoding = PAYLOAD_ENCODING_COMPRESSED;
+        }
+
+#if CFU_CONTENT_WINDOW_MAX
+        // An encoded stream has to be decoded in order, so it gets no window.
+        // Nor does a component that coalesces writes, as it would have to
+        // buffer a window of blocks to program each page once, in order.
+        if ((payloadEncoding != PAYLOAD_ENCODING_NONE) || _CoalescesWrites(pRegistration))
+        {
+            contentWindow = 0;
+        }
+
+#endif
+#if CFU_UNORDERED_CONTENT
+        // A component that coalesces writes programs each page once, in
+        // address order. Ranges the host leaves out after they matched
+        // would never be received. Neither takes out of order content.
+        if (_CoalescesWrites(pRegistration))
+        {
+            unorderedContent = FALSE;
+        }
+#if CFU_RANGE_COMPARE
+        if (s_rangesMatched[componentId >> 3] & (1u << (componentId & 7)))
+        {
+            unorderedContent = FALSE;
+        }
+#endif
+
+        // Nor can an encoded stream be sent out of order. Out of order
+        // content needs no window as blocks are not acknowledged in sequence.
+        if (payloadEncoding != PAYLOAD_ENCODING_NONE)
+        {
+            unorderedContent = FALSE;
+        }
+#if CFU_CONTENT_WINDOW_MAX
+        else if (unorderedContent)
+        {
+            contentWindow = 0;
+        }
+#endif
+
+#endif
+        // The payload is encoded in a way the component cannot take
+        if (!encodingSupported)
+        {
+            memset(pResponse, 0, sizeof (FWUPDATE_OFFER_RESPONSE));
+
+            pResponse->status = FIRMWARE_UPDATE_OFFER_REJECT;
+            pResponse->rejectReasonCode = FIRMWARE_OFFER_REJECT_ENCODING;
+            pResponse->token = token;
+            return;
+        }
+
+        // Found a matching componentId, present the offer to the handler
+        TIMING_START(offerStart);
+        _ComponentProcessOffer(pRegistration, pCommand, pResponse);
+
+        // This sample code shows how to send offer information
+        // that includes the request to ignore checking any version
+        // info. 
+        // If we're ignoring FWVersion check, and that was the reason 
+        // the offer was rejected, reverse the decision
+        // NOTE:  in released/final Firmware, this ability to accept
+        //        any version is usually disabled in FW (this is a TODO
+        //        for implementers of CFU)
+        if (ignoreVersion)
+        {
+            if ((pResponse->status == FIRMWARE_UPDATE_OFFER_REJECT) 
+                    && (pResponse->rejectReasonCode == FIRMWARE_OFFER_REJECT_OLD_FW))
+            {
+                pResponse->status = FIRMWARE_UPDATE_OFFER_ACCEPT;
+            }
+        }
+
+        // This is the point detecting that the offer is accepted
+        // This implementation starts a timer to ensure the FW
+        // does not wait forever for the update process to complete.
+        if (pResponse->status == FIRMWARE_UPDATE_OFFER_ACCEPT)
+        {
+#if CFU_BACKGROUND_VERIFY
+            // A verification dropped by the fail safe timer ends here
+            if (pSession->verifyPending)
+            {
+                _EndVerification(pSession, FIRMWARE_UPDATE_STATUS_ERROR_NO_OFFER);
+            }
+#endif
+            BSP_Timer_Restart(s_updateTimer);
+#if CFU_INACTIVITY_TIMEOUT_MS
+            pSession->idleMs = 0;
+            BSP_Timer_Restart(s_inactivityTimer);
+#endif
+            pSession->updateInProgress = TRUE;
+            pSession->forceReset = forceReset;
+            pSession->activeComponentId = componentId;
+            pSession->pActiveComponent = pRegistration;
+            pSession->pStorage = _FindStorage(pRegistration);
+#if CFU_TIMING_STATS
+            _ResetTiming(pSession);
+#endif
+            TIMING_STOP(pSession, CFU_TIMING_PHASE_OFFER, offerStart);
+#if CFU_CONTENT_WINDOW_MAX
+            // Grant the host at most the content window it asked for
+            pSession->contentWindow = (contentWindow < CFU_CONTENT_WINDOW_MAX) ?
+                                            contentWindow : CFU_CONTENT_WINDOW_MAX;
+            pSession->windowStarted = FALSE;
+            pResponse->contentWindow = pSession->contentWindow;
+#endif
+#if CFU_UNORDERED_CONTENT
+            pSession->unorderedContent = unorderedContent;
+            pSession->unorderedStarted = FALSE;
+            pResponse->unorderedContent = unorderedContent;
+#endif
+#if CFU_BACKGROUND_VERIFY
+            pSession->backgroundVerify = backgroundVerify;
+            pSession->verifyDone = FALSE;
+            pResponse->backgroundVerify = backgroundVerify;
+#endif
+#if CFU_ENCODED_PAYLOAD
+            pSession->payloadEncoding = payloadEncoding;
+#endif
+#if CFU_RESUMABLE_TRANSFER
+            // The host may continue from the stored resume point of this
+            // version, or start over with a first block. Encoded payloads
+            // always start over, and so does out of order content.
+            pSession->offerVersion = version;
+            pSession->resumePending = (payloadEncoding == PAYLOAD_ENCODING_NONE) && 
+                _LoadCheckpoint(&pSession->checkpoint, componentId, version);
+#if CFU_UNORDERED_CONTENT
+            pSession->resumePending = pSession->resumePending && !unorderedContent;
+#endif
+            pSession->checkpoint.componentId = componentId;
+#endif
+        }
+    }
+}
+
+//******************************************************************************
+//
+// ProcessCFWUGetFWVersion - Process the get firmware version component firmware 
+// update command.
+//
+// The command carries no page index. While the page it reported had
+// extensionFlag set, the next read reports the page that follows. The read
+// after the last page, or after any offer, starts over at page 0, so a host
+// that reads once before offering gets the legacy response.
+//
+// Input Parameters
+//      GET_FWVERSION_RESPONSE* pResponse - The response to populate.
+//
+//******************************************************************************
+void ProcessCFWUGetFWVersion(GET_FWVERSION_RESPONSE* pResponse)
+{
+    ProcessCFWUGetFWVersionPage(s_fwVersionPage, pResponse);
+
+    s_fwVersionPage = pResponse->header.extensionFlag ? (UINT8)(s_fwVersionPage + 1) : 0;
+}
+
+//******************************************************************************
+//
+// ProcessCFWUGetFWVersionPage - Process a get firmware version command for
+// one page of the registered components.
+//
+// The blob only has room for CFU_FWVERSION_COMPONENTS_PER_PAGE components.
+// When more are registered, extensionFlag is set and the host reads the
+// following pages (page 1, 2, ...) until a page comes back without it.
+// ProcessCFWUGetFWVersion walks the pages on successive reads; a transport
+// that carries the page index itself (e.g. a report ID per page) can call
+// this function directly.
+//
+// Input Parameters
+//      UINT8 pageIndex - The page to report. Page 0 is the legacy response.
+//      GET_FWVERSION_RESPONSE* pResponse - The response to populate.
+//
+//******************************************************************************
+void ProcessCFWUGetFWVersionPage(UINT8 pageIndex, GET_FWVERSION_RESPONSE* pResponse)
+{
+    //Received CFWU GetFwVersion
+
+    ASSERT(pResponse != NULL);
+
+    memset(pResponse, 0, sizeof(GET_FWVERSION_RESPONSE));
+
+    //CFU Protocol version
+    pResponse->header.fwUpdateRevision = CPFWU_REVISION;
+
+    UINT16 firstComponent = (UINT16)pageIndex * CFU_FWVERSION_COMPONENTS_PER_PAGE;
+    UINT16 componentIndex = firstComponent;
+    UINT8 componentCount = 0;
+
+#if CFU_VERSION_CACHE
+    // Served from the snapshot, without calling into the components.
+    if (componentIndex < COMPONENT_COUNT)
+    {
+        componentCount = (UINT8)(COMPONENT_COUNT - componentIndex);
+        if (componentCount > CFU_FWVERSION_COMPONENTS_PER_PAGE)
+        {
+            componentCount = CFU_FWVERSION_COMPONENTS_PER_PAGE;
+        }
+        memcpy(pResponse->versionAndProductInfoBlob, 
+               s_versionCache[componentIndex], 
+               componentCount * sizeof(s_versionCache[0]));
+        componentIndex += componentCount;
+    }
+#else
+    // Fill out the Version and Product Info (variable length)
+    UINT32* pVersion = (UINT32*)pResponse->versionAndProductInfoBlob;
+
+    // NOTE: it is assumed component registration has already been completed
+    //       before this function is called and that registration will not
+    //       change for the duration of the running image. If this is NOT
+    //       correct for your implementation - it is left up to the developer
+    //       to wrap the registration iteration below in a thread safe construct.
+    while ((componentIndex < COMPONENT_COUNT) &&
+           (componentCount < CFU_FWVERSION_COMPONENTS_PER_PAGE))
+    {
+        const COMPONENT_REGISTRATION* pRegistration = COMPONENT_AT(componentIndex);
+
+        // This gathers the version and product info
+        // of the components on this page.
+        // Developer TODO - implement and register version and product 
+        //                  info gathering functions
+        _ComponentGetVersion(pRegistration, pVersion);
+        pVersion++;
+        _ComponentGetProductInfo(pRegistration, pVersion);
+        pVersion++;
+        componentIndex++;
+        componentCount++;
+    }
+#endif
+
+    pResponse->header.componentCount = componentCount;
+    pResponse->header.firstComponent = firstComponent;
+    pResponse->header.extensionFlag = (componentIndex < COMPONENT_COUNT) ? 1 : 0;
+}
+
+//******************************************************************************
+//
+// ProcessCFWUGetTiming - Report how long one phase of the last update of a
+// component took, for host tooling to break the update time down.
+//
+// Input Parameters
+//      UINT8 componentId - The component.
+//      UINT8 phase - CFU_TIMING_PHASE_xxx
+//      GET_TIMING_RESPONSE* pResponse - The response to populate. count is 0
+//              if the component has not been updated or the phase is
+//              unknown.
+//
+//******************************************************************************
+void ProcessCFWUGetTiming(UINT8 componentId, UINT8 phase, GET_TIMING_RESPONSE* pResponse)
+{
+    ASSERT(pResponse != NULL);
+
+    memset(pResponse, 0, sizeof(GET_TIMING_RESPONSE));
+
+    pResponse->componentId = componentId;
+    pResponse->phase = phase;
+
+#if CFU_TIMING_STATS
+    pResponse->ticksPerSecond = CFU_TIMING_TICK_HZ;
+
+    if (phase < CFU_TIMING_PHASE_COUNT)
+    {
+        UINT8 sessionId;
+
+        for (sessionId = 0; sessionId < CFU_MAX_SESSIONS; sessionId++)
+        {
+            CURRENT_OFFER_INFO* pSession = &s_sessions[sessionId];
+
+            // Only the session that accepted the last offer for the
+            // component has its offer timed.
+            if ((pSession->activeComponentId == componentId) &&
+                (pSession->timing[CFU_TIMING_PHASE_OFFER].count != 0))
+            {
+                CFU_TIMING_STAT* pStat = &pSession->timing[phase];
+
+                pResponse->count = pStat->count;
+                pResponse->minTicks = (pStat->count != 0) ? pStat->minTicks : 0;
+                pResponse->maxTicks = pStat->maxTicks;
+                pResponse->totalTicks = pStat->totalTicks;
+                break;
+            }
+        }
+    }
+#endif
+}
+
+//****************************************************************************
+//
+// IComponentFirmwareUpdateRegisterComponent - Register component interface
+//
+//    NOTE: Does nothing when CFU_STATIC_COMPONENTS is enabled, the components
+//          are those of CFU_COMPONENT_TABLE.
+//
+// Input Parameters
+//      COMPONENT_REGISTRATION* pRegistration.
+//
+//****************************************************************************
+void IComponentFirmwareUpdateRegisterComponent(COMPONENT_REGISTRATION* pRegistration)
+{
+#if CFU_STATIC_COMPONENTS
+    (void)pRegistration;
+#else
+    if (!pRegistration)
+    {
+        return;
+    }
+
+    // Because registration can happen from any thread
+    // - we will need to wrap the below in a thread safe construct
+    //   It is left up to implementation to provide such construct.
+    
+    // Developer TODO  -Implementation of thread safety is left to developer
+    //                  (example critical section calls below)
+    //  ENTER_CRITICAL_SECTION();
+    {
+        UINT8 index = _ComponentIndex(pRegistration->componentId);
+
+        if (index != 0)
+        {
+            // Re-registering a componentId replaces its earlier registration.
+            s_pComponents[index - 1] = pRegistration;
+        }
+        else if (s_componentCount < MAX_REGISTERED_COMPONENTS)
+        {
+#if CFU_COMPONENT_INDEX_TABLE
+            s_componentIndex[pRegistration->componentId] = s_componentCount + 1;
+#else
+            UINT8 slot = s_componentCount;
+
+            // Insert the new position where it keeps the order sorted
+            while ((slot > 0) && (s_pComponents[s_componentOrder[slot - 1]]->componentId > 
+                                  pRegistration->componentId))
+            {
+                s_componentOrder[slot] = s_componentOrder[slot - 1];
+                slot--;
+            }
+            s_componentOrder[slot] = s_componentCount;
+#endif
+            s_pComponents[s_componentCount++] = pRegistration;
+        }
+        else
+        {
+            // Developer TODO - increase MAX_REGISTERED_COMPONENTS
+            ASSERT(FALSE);
+        }
+    }
+    // EXIT_CRITICAL_SECTION();
+
+#if CFU_VERSION_CACHE
+    IComponentFirmwareUpdateRefreshVersion(pRegistration->componentId);
+#endif
+#endif
+}
+
+//****************************************************************************
+//
+// IComponentFirmwareUpdateRefreshVersion - Re-read a component's version and
+// product info into the snapshot served by ProcessCFWUGetFWVersion.
+//
+//    NOTE: Only needed when CFU_VERSION_CACHE is enabled. Call it when a
+//          component starts running a different image other than through
+//          NotifySuccess or a restart of the engine, e.g. once a bank swap
+//          has completed.
+//
+// Input Parameters
+//      UINT8 componentId - The component whose version changed.
+//
+//****************************************************************************
+void IComponentFirmwareUpdateRefreshVersion(UINT8 componentId)
+{
+#if CFU_VERSION_CACHE
+    UINT8 index = _ComponentIndex(componentId);
+
+    if (index != 0)
+    {
+        _RefreshVersionCache(index - 1);
+    }
+#else
+    (void)componentId;
+#endif
+}
\ No newline at end of file
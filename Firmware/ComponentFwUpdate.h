@@ -1,227 +1,395 @@
-/*++
-    This file is part of Component Firmware Update (CFU), licensed under
-    the MIT License (MIT).
-
-    Copyright (c) Microsoft Corporation. All rights reserved.
-
-    Permission is hereby granted, free of charge, to any person obtaining a copy
-    of this software and associated documentation files (the "Software"), to deal
-    in the Software without restriction, including without limitation the rights
-    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-    copies of the Software, and to permit persons to whom the Software is
-    furnished to do so, subject to the following conditions:
-    
-    The above copyright notice and this permission notice shall be included in all
-    copies or substantial portions of the Software.
-    
-    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-    SOFTWARE.
-
-Module Name:
-
-    ComponentFwUpdate.h
-
-Abstract:
-
-    Header file for the component firmware update functionality..
-
-Environment:
-
-    Firmware driver. 
---*/
-
-#pragma once
-
-//****************************************************************************
-//
-//                               INCLUDES
-//
-//****************************************************************************
-#include "coretypes.h"
-
-//****************************************************************************
-//
-//                                  DEFINES
-//
-//****************************************************************************
-// NOTE - defines should match CFU Protocol Spec definitions
-#define CFU_OFFER_METADATA_INFO_CMD                        (0xFF)
-#define CFU_SPECIAL_OFFER_CMD                              (0xFE)
-#define CFU_SPECIAL_OFFER_GET_STATUS                       (0x03)
-#define CFU_SPECIAL_OFFER_NONCE                            (0x02)
-#define CFU_SPECIAL_OFFER_NOTIFY_ON_READY                  (0x01)
-#define CFW_UPDATE_PACKET_MAX_LENGTH                       (sizeof(FWUPDATE_CONTENT_COMMAND))
-#define FIRMWARE_OFFER_REJECT_BANK                         (0x04)
-#define FIRMWARE_OFFER_REJECT_INV_MCU                      (0x01)
-#define FIRMWARE_OFFER_REJECT_MISMATCH                     (0x03)
-#define FIRMWARE_OFFER_REJECT_OLD_FW                       (0x00)
-#define FIRMWARE_OFFER_TOKEN_DRIVER                        (0xA0)
-#define FIRMWARE_OFFER_TOKEN_SPEEDFLASHER                  (0xB0)
-#define FIRMWARE_UPDATE_CMD_NOT_SUPPORTED                  (0xFF)
-#define FIRMWARE_UPDATE_FLAG_FIRST_BLOCK                   (0x80)
-#define FIRMWARE_UPDATE_FLAG_LAST_BLOCK                    (0x40)
-#define FIRMWARE_UPDATE_FLAG_VERIFY                        (0x08)
-#define FIRMWARE_UPDATE_OFFER_ACCEPT                       (0x01)
-#define FIRMWARE_UPDATE_OFFER_BUSY                         (0x03)
-#define FIRMWARE_UPDATE_OFFER_COMMAND_READY                (0x04)
-#define FIRMWARE_UPDATE_OFFER_REJECT                       (0x02)
-#define FIRMWARE_UPDATE_OFFER_SKIP                         (0x00)
-#define FIRMWARE_UPDATE_OFFER_SWAP_PENDING                 (0x02)
-#define FIRMWARE_UPDATE_STATUS_ERROR_COMPLETE              (0x03)
-#define FIRMWARE_UPDATE_STATUS_ERROR_CRC                   (0x05)
-#define FIRMWARE_UPDATE_STATUS_ERROR_INVALID               (0x0B)
-#define FIRMWARE_UPDATE_STATUS_ERROR_INVALID_ADDR          (0x09)
-#define FIRMWARE_UPDATE_STATUS_ERROR_NO_OFFER              (0x0A)
-#define FIRMWARE_UPDATE_STATUS_ERROR_PENDING               (0x08)
-#define FIRMWARE_UPDATE_STATUS_ERROR_PREPARE               (0x01)
-#define FIRMWARE_UPDATE_STATUS_ERROR_SIGNATURE             (0x06)
-#define FIRMWARE_UPDATE_STATUS_ERROR_VERIFY                (0x04)
-#define FIRMWARE_UPDATE_STATUS_ERROR_VERSION               (0x07)
-#define FIRMWARE_UPDATE_STATUS_ERROR_WRITE                 (0x02)
-#define FIRMWARE_UPDATE_STATUS_SUCCESS                     (0x00)
-#define OFFER_INFO_END_OFFER_LIST                          (0x02)
-#define OFFER_INFO_START_ENTIRE_TRANSACTION                (0x00)
-#define OFFER_INFO_START_OFFER_LIST                        (0x01)
-//****************************************************************************
-//
-//                                  TYPEDEFS
-//
-//****************************************************************************
-// Suppress the warning about bit fields for only signed and unsigned integers.
-//#pragma diag_suppress=Pm095
-#pragma pack(1)
-typedef struct
-{
-    struct
-    {
-        UINT8 componentCount;
-        UINT16 reserved0;
-        UINT8 fwUpdateRevision : 4;
-        UINT8 reserved1 : 3;
-        UINT8 extensionFlag : 1;
-    } header;
-    UINT8 versionAndProductInfoBlob[20];
-} GET_FWVERSION_RESPONSE;
-
-typedef struct
-{
-    struct
-    {
-        UINT8 segmentNumber;
-        UINT8 reserved0 : 6;
-        UINT8 forceImmediateReset : 1;
-        UINT8 forceIgnoreVersion : 1;
-        UINT8 componentId;
-        UINT8 token;
-    } componentInfo;
-
-    UINT32 version;
-    UINT32 hwVariantMask;
-    struct
-    {
-        UINT8 protocolRevision : 4;
-        UINT8 bank : 2;
-        UINT8 reserved0 : 2;
-        UINT8 milestone : 3;
-        UINT8 reserved1 : 5;
-        UINT16 productId;
-    } productInfo;
-
-} FWUPDATE_OFFER_COMMAND;
-
-typedef struct
-{
-    struct
-    {
-        UINT8 infoCode;
-        UINT8 reserved0;
-        UINT8 shouldBe0xFF;
-        UINT8 token;
-    } componentInfo;
-
-    UINT32 reserved0[3];
-
-} FWUPDATE_OFFER_INFO_ONLY_COMMAND;
-
-typedef struct
-{
-    struct
-    {
-        UINT8 commandCode;
-        UINT8 reserved0;
-        UINT8 shouldBe0xFE;
-        UINT8 token;
-    } componentInfo;
-
-    UINT32 reserved0[3];
-
-} FWUPDATE_SPECIAL_OFFER_COMMAND;
-
-typedef struct
-{
-    union
-    {
-        struct
-        {
-            UINT8 reserved0[3];
-            UINT8 token;
-            UINT32 reserved1;
-            UINT8 rejectReasonCode;
-            UINT8 reserved2[3];
-            UINT8 status;
-            UINT8 reserved3[3];
-        };
-    };
-} FWUPDATE_OFFER_RESPONSE;
-
-typedef struct
-{
-    UINT8 flags;
-    UINT8 length;
-    UINT16 sequenceNumber;
-    UINT32 address;
-    UINT8 pData[MAX_UINT8];
-} FWUPDATE_CONTENT_COMMAND;
-
-typedef struct
-{
-    union
-    {
-        struct
-        {
-            UINT16 sequenceNumber;
-            UINT16 reserved0;
-            UINT8 status;
-            UINT8 reserved1[3];
-            UINT32 reserved2[2];
-        };
-    };
-} FWUPDATE_CONTENT_RESPONSE;
-
-typedef enum
-{
-    BSP_YOURCOMPONENT      = (0x01U),
-    // Developer TODO - Add more platform component ID's here
-} FWUPDATE_PFID;
-
-#pragma pack()
-//#pragma diag_default=Pm095
-//****************************************************************************
-//
-//                          GLOBAL VARIABLE EXTERNS
-//
-//****************************************************************************
-
-//****************************************************************************
-//
-//                          GLOBAL FUNCTION EXTERNS
-//
-//****************************************************************************
-void ProcessCFWUContent(FWUPDATE_CONTENT_COMMAND* pCommand, FWUPDATE_CONTENT_RESPONSE* pResponse);
-void ProcessCFWUOffer(FWUPDATE_OFFER_COMMAND* pCommand, FWUPDATE_OFFER_RESPONSE* pResponse);
-void ProcessCFWUGetFWVersion(GET_FWVERSION_RESPONSE* pResponse);
+/*++
+    This file is part of Component Firmware Update (CFU), licensed under
+    the MIT License (MIT).
+
+    Copyright (c) Microsoft Corporation. All rights reserved.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+    
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+    
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+Module Name:
+
+    ComponentFwUpdate.h
+
+Abstract:
+
+    Header file for the component firmware update functionality..
+
+Environment:
+
+    Firmware driver. 
+--*/
+
+#pragma once
+
+//****************************************************************************
+//
+//                               INCLUDES
+//
+//****************************************************************************
+#include "coretypes.h"
+
+//****************************************************************************
+//
+//                                  DEFINES
+//
+//****************************************************************************
+// NOTE - defines should match CFU Protocol Spec definitions, except
+// FIRMWARE_UPDATE_OFFER_DEFERRED. It is not in the spec and is only returned
+// to a host that opted in: for offers sent between OFFER_INFO_START_OFFER_LIST
+// and OFFER_INFO_END_OFFER_LIST, and for NOTIFY_ON_READY on an image whose
+// offer set backgroundVerify. The response it stands for is sent later with
+// ICompFwUpdateBspSendOfferResponse.
+#define CFU_COMPARE_CONTENT_RANGES                         (6)
+#define CFU_COMPARE_HASH_SIZE                              (8)
+#define CFU_COMPARE_MAX_RANGES                             (1)
+#define CFU_COMPRESS_MIN_MATCH                             (3)
+#define CFU_COMPRESS_TOKEN_MATCH                           (0x80)
+#define CFU_DELTA_OP_COPY                                  (0x01)
+#define CFU_DELTA_OP_INSERT                                (0x02)
+#define CFU_DELTA_OP_SEEK                                  (0x03)
+#define CFU_OFFER_METADATA_INFO_CMD                        (0xFF)
+#define CFU_SPECIAL_OFFER_ABORT                            (0x05)
+#define CFU_SPECIAL_OFFER_ABORT_ALL                        (0xFF)
+#define CFU_SPECIAL_OFFER_CMD                              (0xFE)
+#define CFU_SPECIAL_OFFER_COMPARE_RANGES                   (0x06)
+#define CFU_SPECIAL_OFFER_GET_RESUME_POINT                 (0x04)
+#define CFU_SPECIAL_OFFER_GET_STATUS                       (0x03)
+#define CFU_SPECIAL_OFFER_NONCE                            (0x02)
+#define CFU_SPECIAL_OFFER_NOTIFY_ON_READY                  (0x01)
+#define CFU_TIMING_PHASE_AUTHENTICATE                      (0x05)
+#define CFU_TIMING_PHASE_COUNT                             (0x07)
+#define CFU_TIMING_PHASE_CRC                               (0x04)
+#define CFU_TIMING_PHASE_ERASE                             (0x02)
+#define CFU_TIMING_PHASE_NOTIFY                            (0x06)
+#define CFU_TIMING_PHASE_OFFER                             (0x00)
+#define CFU_TIMING_PHASE_PREPARE                           (0x01)
+#define CFU_TIMING_PHASE_WRITE                             (0x03)
+#define CFW_UPDATE_PACKET_MAX_LENGTH                       (sizeof(FWUPDATE_CONTENT_COMMAND))
+#define CFU_FWVERSION_COMPONENTS_PER_PAGE                  (20 / (2 * sizeof(UINT32)))
+#define FIRMWARE_OFFER_REJECT_BANK                         (0x04)
+#define FIRMWARE_OFFER_REJECT_ENCODING                     (0xE0)  // Vendor specific range
+#define FIRMWARE_OFFER_REJECT_INV_MCU                      (0x01)
+#define FIRMWARE_OFFER_REJECT_MISMATCH                     (0x03)
+#define FIRMWARE_OFFER_REJECT_OLD_FW                       (0x00)
+#define FIRMWARE_OFFER_TOKEN_DRIVER                        (0xA0)
+#define FIRMWARE_OFFER_TOKEN_SPEEDFLASHER                  (0xB0)
+#define FIRMWARE_UPDATE_CMD_NOT_SUPPORTED                  (0xFF)
+#define FIRMWARE_UPDATE_FLAG_COMPARE                       (0x10)
+#define FIRMWARE_UPDATE_FLAG_FIRST_BLOCK                   (0x80)
+#define FIRMWARE_UPDATE_FLAG_LAST_BLOCK                    (0x40)
+#define FIRMWARE_UPDATE_FLAG_SESSION_MASK                  (0x03)
+#define FIRMWARE_UPDATE_FLAG_VERIFY                        (0x08)
+#define FIRMWARE_UPDATE_OFFER_ACCEPT                       (0x01)
+#define FIRMWARE_UPDATE_OFFER_BUSY                         (0x03)
+#define FIRMWARE_UPDATE_OFFER_COMMAND_READY                (0x04)
+#define FIRMWARE_UPDATE_OFFER_DEFERRED                     (0xFE)
+#define FIRMWARE_UPDATE_OFFER_REJECT                       (0x02)
+#define FIRMWARE_UPDATE_OFFER_SKIP                         (0x00)
+#define FIRMWARE_UPDATE_OFFER_SWAP_PENDING                 (0x02)
+#define FIRMWARE_UPDATE_STATUS_ERROR_COMPLETE              (0x03)
+#define FIRMWARE_UPDATE_STATUS_ERROR_CRC                   (0x05)
+#define FIRMWARE_UPDATE_STATUS_ERROR_INVALID               (0x0B)
+#define FIRMWARE_UPDATE_STATUS_ERROR_INVALID_ADDR          (0x09)
+#define FIRMWARE_UPDATE_STATUS_ERROR_NO_OFFER              (0x0A)
+#define FIRMWARE_UPDATE_STATUS_ERROR_PENDING               (0x08)
+#define FIRMWARE_UPDATE_STATUS_ERROR_PREPARE               (0x01)
+#define FIRMWARE_UPDATE_STATUS_ERROR_SIGNATURE             (0x06)
+#define FIRMWARE_UPDATE_STATUS_ERROR_VERIFY                (0x04)
+#define FIRMWARE_UPDATE_STATUS_ERROR_VERSION               (0x07)
+#define FIRMWARE_UPDATE_STATUS_ERROR_WRITE                 (0x02)
+#define FIRMWARE_UPDATE_STATUS_SUCCESS                     (0x00)
+#define OFFER_INFO_END_OFFER_LIST                          (0x02)
+#define OFFER_INFO_START_ENTIRE_TRANSACTION                (0x00)
+#define OFFER_INFO_START_OFFER_LIST                        (0x01)
+//****************************************************************************
+//
+//                                  TYPEDEFS
+//
+//****************************************************************************
+// Suppress the warning about bit fields for only signed and unsigned integers.
+//#pragma diag_suppress=Pm095
+#pragma pack(1)
+// firstComponent is reserved0 of the CFU spec. It is 0 in page 0, which is
+// all a host that ignores extensionFlag reads, see ProcessCFWUGetFWVersion.
+typedef struct
+{
+    struct
+    {
+        UINT8 componentCount;           // Components in this page's blob
+        UINT16 firstComponent;          // Index of the first component in this page
+        UINT8 fwUpdateRevision : 4;
+        UINT8 reserved1 : 3;
+        UINT8 extensionFlag : 1;        // More components follow in later pages
+    } header;
+    UINT8 versionAndProductInfoBlob[20];
+} GET_FWVERSION_RESPONSE;
+
+typedef struct
+{
+    UINT8 componentId;
+    UINT8 phase;                    // CFU_TIMING_PHASE_xxx
+    UINT16 reserved0;
+    UINT32 ticksPerSecond;          // 0 when timing is not compiled in
+    UINT32 count;                   // Calls timed in the last update
+    UINT32 minTicks;
+    UINT32 maxTicks;
+    UINT64 totalTicks;
+} GET_TIMING_RESPONSE;
+
+typedef struct
+{
+    struct
+    {
+        UINT8 segmentNumber;
+        UINT8 contentWindow : 6;    // Requested content window, 0 for stop-and-wait
+        UINT8 forceImmediateReset : 1;
+        UINT8 forceIgnoreVersion : 1;
+        UINT8 componentId;
+        UINT8 token;
+    } componentInfo;
+
+    UINT32 version;
+    UINT32 hwVariantMask;
+    struct
+    {
+        UINT8 protocolRevision : 4;
+        UINT8 bank : 2;
+        UINT8 sessionId : 2;        // Update session, see FIRMWARE_UPDATE_FLAG_SESSION_MASK
+        UINT8 milestone : 3;
+        UINT8 deltaPayload : 1;     // Content is a patch against the running image
+        UINT8 compressedPayload : 1;// Content is compressed, see CFU_COMPRESS_xxx
+        UINT8 unorderedContent : 1; // Content blocks may be sent in any order
+        UINT8 backgroundVerify : 1; // Answer the last block before verifying
+        UINT8 reserved1 : 1;
+        UINT16 productId;
+    } productInfo;
+
+} FWUPDATE_OFFER_COMMAND;
+
+typedef struct
+{
+    struct
+    {
+        UINT8 infoCode;
+        UINT8 reserved0;
+        UINT8 shouldBe0xFF;
+        UINT8 token;
+    } componentInfo;
+
+    UINT32 reserved0[3];
+
+} FWUPDATE_OFFER_INFO_ONLY_COMMAND;
+
+typedef struct
+{
+    struct
+    {
+        UINT8 commandCode;
+        UINT8 reserved0;
+        UINT8 shouldBe0xFE;
+        UINT8 token;
+    } componentInfo;
+
+    UINT32 reserved0[3];
+
+} FWUPDATE_SPECIAL_OFFER_COMMAND;
+
+typedef struct
+{
+    struct
+    {
+        UINT8 commandCode;          // CFU_SPECIAL_OFFER_GET_RESUME_POINT
+        UINT8 componentId;
+        UINT8 shouldBe0xFE;
+        UINT8 token;
+    } componentInfo;
+
+    UINT32 version;                 // Version of the image to resume
+    UINT32 reserved0[2];
+
+} FWUPDATE_RESUME_OFFER_COMMAND;
+
+typedef struct
+{
+    struct
+    {
+        UINT8 commandCode;          // CFU_SPECIAL_OFFER_ABORT
+        UINT8 componentId;          // or CFU_SPECIAL_OFFER_ABORT_ALL
+        UINT8 shouldBe0xFE;
+        UINT8 token;
+    } componentInfo;
+
+    UINT32 reserved0[3];
+
+} FWUPDATE_ABORT_OFFER_COMMAND;
+
+typedef struct
+{
+    struct
+    {
+        UINT8 commandCode;          // CFU_SPECIAL_OFFER_NOTIFY_ON_READY
+        UINT8 componentId;          // Component whose image is being verified
+        UINT8 shouldBe0xFE;
+        UINT8 token;
+    } componentInfo;
+
+    UINT32 reserved0[3];
+
+} FWUPDATE_NOTIFY_OFFER_COMMAND;
+
+typedef struct
+{
+    struct
+    {
+        UINT8 commandCode;          // CFU_SPECIAL_OFFER_COMPARE_RANGES
+        UINT8 componentId;
+        UINT8 shouldBe0xFE;
+        UINT8 token;
+    } componentInfo;
+
+    UINT16 firstRange;              // Range n starts at n << rangeShift
+    UINT8 rangeShift;
+    UINT8 rangeCount;               // At most CFU_COMPARE_MAX_RANGES
+    // First CFU_COMPARE_HASH_SIZE bytes of the SHA-256 (see Sha256.h) of each range
+    UINT8 hash[CFU_COMPARE_MAX_RANGES][CFU_COMPARE_HASH_SIZE];
+
+} FWUPDATE_COMPARE_OFFER_COMMAND;
+
+typedef struct
+{
+    union
+    {
+        struct
+        {
+            UINT8 contentWindow;    // Granted content window, 0 for stop-and-wait
+            UINT8 unorderedContent; // 1 when content may be sent in any order
+            UINT8 backgroundVerify; // 1 when the image is verified in the background
+            UINT8 token;
+            UINT8 componentId;      // Set in the decisions of an offer list
+            UINT8 reserved1[3];
+            UINT8 rejectReasonCode;
+            UINT8 reserved2[3];
+            UINT8 status;
+            UINT8 reserved3[3];
+        };
+    };
+} FWUPDATE_OFFER_RESPONSE;
+
+typedef struct
+{
+    UINT8 verifyStatus;             // FIRMWARE_UPDATE_STATUS_xxx of the image
+    UINT8 componentId;
+    UINT8 reserved0;
+    UINT8 token;
+    UINT32 reserved1;
+    UINT8 rejectReasonCode;
+    UINT8 reserved2[3];
+    UINT8 status;
+    UINT8 reserved3[3];
+} FWUPDATE_NOTIFY_OFFER_RESPONSE;
+
+typedef struct
+{
+    UINT16 sequenceNumber;          // Last block covered by the resume point
+    UINT8 reserved0;
+    UINT8 token;
+    UINT32 address;                 // End of the last block covered
+    UINT8 rejectReasonCode;
+    UINT8 reserved2[3];
+    UINT8 status;
+    UINT8 reserved3[3];
+} FWUPDATE_RESUME_OFFER_RESPONSE;
+
+typedef struct
+{
+    UINT8 matchMask;                // Bit n set - range firstRange + n matches
+    UINT8 reserved0[2];
+    UINT8 token;
+    UINT32 reserved1;
+    UINT8 rejectReasonCode;
+    UINT8 reserved2[3];
+    UINT8 status;
+    UINT8 reserved3[3];
+} FWUPDATE_COMPARE_OFFER_RESPONSE;
+
+typedef struct
+{
+    UINT8 flags;
+    UINT8 length;
+    UINT16 sequenceNumber;
+    UINT32 address;
+    UINT8 pData[MAX_UINT8];
+} FWUPDATE_CONTENT_COMMAND;
+
+// Data of a content command flagged FIRMWARE_UPDATE_FLAG_COMPARE. The length
+// of the command gives the number of hashes, at most
+// CFU_COMPARE_CONTENT_RANGES so that they fill a 60 byte report.
+typedef struct
+{
+    UINT8 componentId;
+    UINT8 rangeShift;
+    UINT16 firstRange;              // Range n starts at n << rangeShift
+    // First CFU_COMPARE_HASH_SIZE bytes of the SHA-256 (see Sha256.h) of each range
+    UINT8 hash[CFU_COMPARE_CONTENT_RANGES][CFU_COMPARE_HASH_SIZE];
+} FWUPDATE_COMPARE_CONTENT;
+
+typedef struct
+{
+    union
+    {
+        struct
+        {
+            UINT16 sequenceNumber;
+            UINT16 ackSequenceNumber;   // Windowed mode: all blocks up to here received
+            UINT8 status;
+            UINT8 reserved1[3];
+            UINT32 selectiveAckMask;    // Windowed mode: bit n - block ackSequenceNumber + 1 + n received
+                                        // Compare: bit n - range firstRange + n matches
+            UINT32 reserved2;
+        };
+    };
+} FWUPDATE_CONTENT_RESPONSE;
+
+typedef enum
+{
+    BSP_YOURCOMPONENT      = (0x01U),
+    // Developer TODO - Add more platform component ID's here
+} FWUPDATE_PFID;
+
+#pragma pack()
+//#pragma diag_default=Pm095
+//****************************************************************************
+//
+//                          GLOBAL VARIABLE EXTERNS
+//
+//****************************************************************************
+
+//****************************************************************************
+//
+//                          GLOBAL FUNCTION EXTERNS
+//
+//****************************************************************************
+UINT32 FirmwareUpdateInit(void);
+void FirmwareUpdateBackgroundTask(void);
+void ProcessCFWUContent(FWUPDATE_CONTENT_COMMAND* pCommand, FWUPDATE_CONTENT_RESPONSE* pResponse);
+void ProcessCFWUContentBuffer(UINT8* pReceive, UINT16 receiveLength, UINT8* pTransmit);
+void ProcessCFWUOffer(FWUPDATE_OFFER_COMMAND* pCommand, FWUPDATE_OFFER_RESPONSE* pResponse);
+void ProcessCFWUGetFWVersion(GET_FWVERSION_RESPONSE* pResponse);
+void ProcessCFWUGetFWVersionPage(UINT8 pageIndex, GET_FWVERSION_RESPONSE* pResponse);
+void ProcessCFWUGetTiming(UINT8 componentId, UINT8 phase, GET_TIMING_RESPONSE* pResponse);
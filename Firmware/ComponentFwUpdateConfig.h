@@ -0,0 +1,301 @@
+/*++
+    This file is part of Component Firmware Update (CFU), licensed under
+    the MIT License (MIT).
+
+    Copyright (c) Microsoft Corporation. All rights reserved.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+Module Name:
+
+    ComponentFwUpdateConfig.h
+
+Abstract:
+
+    Build time configuration of the component firmware update engine.
+
+Environment:
+
+    Firmware driver.
+--*/
+#pragma once
+
+//****************************************************************************
+//
+//                                  DEFINES
+//
+//****************************************************************************
+// Developer TODO - modify the values below to your platform needs. Each can
+//                  also be overridden from the compiler command line.
+
+// Maximum number of components that can be registered with the CFU engine.
+#ifndef MAX_REGISTERED_COMPONENTS
+#define MAX_REGISTERED_COMPONENTS               (16)
+#endif
+
+// Set to 1 to look registered components up in a table indexed by
+// componentId, at the same cost however many are registered, for 256 bytes
+// of RAM. Set to 0 to binary search MAX_REGISTERED_COMPONENTS bytes kept
+// sorted by componentId instead, a few steps for the handful of components
+// of a device. Offers do the lookup; content uses the registration cached
+// by the accepted offer. Not used with CFU_STATIC_COMPONENTS.
+#ifndef CFU_COMPONENT_INDEX_TABLE
+#define CFU_COMPONENT_INDEX_TABLE               (1)
+#endif
+
+// Set to 1 to register components at compile time instead of with
+// IComponentFirmwareUpdateRegisterComponent. CFU_COMPONENT_TABLE_HEADER must
+// then be defined, e.g. on the compiler command line, to name a header that
+// defines CFU_COMPONENT_TABLE(X), see ComponentFwUpdate.c. The core calls
+// the handlers of those components directly, so they can be inlined and
+// nothing else is linked in, and the registrations are kept in flash.
+#ifndef CFU_STATIC_COMPONENTS
+#define CFU_STATIC_COMPONENTS                   (0)
+#endif
+
+// Set to 1 to keep a snapshot of every registered component's version and
+// product info (8 bytes of RAM per component). ProcessCFWUGetFWVersion then
+// copies from the snapshot instead of calling GetVersion and GetProductInfo;
+// it is read at registration and refreshed after NotifySuccess, at
+// FirmwareUpdateInit and through IComponentFirmwareUpdateRefreshVersion.
+#ifndef CFU_VERSION_CACHE
+#define CFU_VERSION_CACHE                       (0)
+#endif
+
+// Set to 1 to time each phase of an update (offer, prepare, erase, write,
+// CRC, authentication, NotifySuccess) with ICompFwUpdateBspGetTicks. The
+// count, minimum, maximum and total of each phase of the last update in a
+// session are read with ProcessCFWUGetTiming.
+#ifndef CFU_TIMING_STATS
+#define CFU_TIMING_STATS                        (0)
+#endif
+
+// Rate of the ICompFwUpdateBspGetTicks counter, reported to the host so
+// that it can convert ticks to time.
+#ifndef CFU_TIMING_TICK_HZ
+#define CFU_TIMING_TICK_HZ                      (1000000)
+#endif
+
+// Set to 1 to compile in support for accumulating the image CRC as each
+// content block is written (see COMPONENT_FLAG_STREAMING_CRC). The last
+// block then only compares the running CRC against the embedded one instead
+// of re-reading the whole image through ICompFwUpdateBspCalcCRC.
+#ifndef CFU_STREAMING_CRC
+#define CFU_STREAMING_CRC                       (1)
+#endif
+
+// Set to 1 to use the slice-by-4 CRC16 tables (2KB of constant data) or to
+// 0 to use the byte-wise table only (512 bytes of constant data).
+#ifndef CFU_CRC16_SLICE_BY_4
+#define CFU_CRC16_SLICE_BY_4                    (1)
+#endif
+
+// Set to 1 to compile in support for accumulating a SHA-256 digest of the
+// image as each content block is written (see
+// COMPONENT_FLAG_STREAMING_DIGEST). The last block then hands the digest to
+// ICompFwUpdateBspAuthenticateDigest instead of having
+// ICompFwUpdateBspAuthenticateFWImage re-read the whole image.
+#ifndef CFU_STREAMING_DIGEST
+#define CFU_STREAMING_DIGEST                    (0)
+#endif
+
+// Set to 1 to compress SHA-256 blocks on a hash accelerator through
+// ICompFwUpdateBspSha256Blocks instead of in portable C.
+#ifndef CFU_SHA256_BSP
+#define CFU_SHA256_BSP                          (0)
+#endif
+
+// Set to 1 to compile in the page coalescing write buffer. Components that
+// register a non zero writePageSize then receive whole pages through
+// ICompFwUpdateBspWritePage instead of one ICompFwUpdateBspWrite per block.
+#ifndef CFU_WRITE_COALESCING
+#define CFU_WRITE_COALESCING                    (0)
+#endif
+
+// Size of the page write buffer. Must be at least the largest writePageSize
+// of any registered component.
+#ifndef CFU_WRITE_BUFFER_SIZE
+#define CFU_WRITE_BUFFER_SIZE                   (256)
+#endif
+
+// Set to 1 to compile in asynchronous, double buffered page programming for
+// components registered with COMPONENT_FLAG_ASYNC_WRITE. Requires
+// CFU_WRITE_COALESCING and doubles the RAM used by the page write buffer.
+#ifndef CFU_ASYNC_WRITE
+#define CFU_ASYNC_WRITE                         (0)
+#endif
+
+// Set to 1 to compile in scatter-gather page programming for components
+// registered with COMPONENT_FLAG_WRITE_LIST. Pages are handed to
+// ICompFwUpdateBspWriteList in lists of up to CFU_WRITE_LIST_PAGES, so that
+// a DMA controller can program a whole list with one interrupt. Requires
+// CFU_ASYNC_WRITE; the page write buffer grows to two lists of pages.
+#ifndef CFU_WRITE_LIST
+#define CFU_WRITE_LIST                          (0)
+#endif
+
+#ifndef CFU_WRITE_LIST_PAGES
+#define CFU_WRITE_LIST_PAGES                    (4)
+#endif
+
+// Set to 1 to compile in lazy erase for components that register a non zero
+// eraseSectorSize. Sectors are then erased just before they are first
+// written instead of erasing the whole staging area in
+// ICompFwUpdateBspPrepare, and sectors the image does not use are not erased.
+#ifndef CFU_LAZY_ERASE
+#define CFU_LAZY_ERASE                          (0)
+#endif
+
+// Size of the erased sector bitmap. Content addresses up to
+// CFU_ERASE_BITMAP_BYTES * 8 * eraseSectorSize can be written, e.g. 128 bytes
+// cover 4MB of 4KB sectors.
+#ifndef CFU_ERASE_BITMAP_BYTES
+#define CFU_ERASE_BITMAP_BYTES                  (128)
+#endif
+
+// Set to 1 to answer CFU_SPECIAL_OFFER_COMPARE_RANGES and content commands
+// flagged FIRMWARE_UPDATE_FLAG_COMPARE, which let the host find the ranges of
+// the staging area that already hold the new image and skip their content.
+// Requires CFU_LAZY_ERASE, which leaves them in place.
+#ifndef CFU_RANGE_COMPARE
+#define CFU_RANGE_COMPARE                       (0)
+#endif
+#if CFU_RANGE_COMPARE && !CFU_LAZY_ERASE
+#error CFU_RANGE_COMPARE requires CFU_LAZY_ERASE
+#endif
+
+// Set to 1 to check the address of every content block against the region
+// table of the component (see COMPONENT_REGISTRATION.pRegions) before it is
+// written, so the BSP write functions need no range checks of their own.
+#ifndef CFU_REGION_CHECK
+#define CFU_REGION_CHECK                        (0)
+#endif
+
+// Largest content window granted to a host, at most 32. A host asks for a
+// window in the offer and may then have that many content blocks beyond the
+// cumulative acknowledgement outstanding. Set to 0 to compile out windowed
+// transfers.
+#ifndef CFU_CONTENT_WINDOW_MAX
+#define CFU_CONTENT_WINDOW_MAX                  (16)
+#endif
+
+// Set to 1 to let hosts send content blocks in any order (see the
+// unorderedContent bit of the offer). Received blocks are tracked in a
+// bitmap keyed by address and the image is verified once every block up to
+// the last one is in, so lost blocks can be sent again on their own.
+#ifndef CFU_UNORDERED_CONTENT
+#define CFU_UNORDERED_CONTENT                   (0)
+#endif
+
+// Size of the received block bitmap of each session, at most 8192. Images of
+// up to CFU_RECEIVE_BITMAP_BYTES * 8 blocks can be sent out of order, e.g.
+// 512 bytes cover 208KB in 52 byte blocks.
+#ifndef CFU_RECEIVE_BITMAP_BYTES
+#define CFU_RECEIVE_BITMAP_BYTES                (512)
+#endif
+
+// Set to 1 to let hosts have images verified in the background (see the
+// backgroundVerify bit of the offer). The last block is then answered with
+// FIRMWARE_UPDATE_STATUS_ERROR_PENDING right after it is written, the CRC
+// check, authentication and NotifySuccess run in
+// FirmwareUpdateBackgroundTask, and the host learns the result with a
+// CFU_SPECIAL_OFFER_NOTIFY_ON_READY offer.
+#ifndef CFU_BACKGROUND_VERIFY
+#define CFU_BACKGROUND_VERIFY                   (0)
+#endif
+
+// Set to 1 to evaluate the offers sent between OFFER_INFO_START_OFFER_LIST
+// and OFFER_INFO_END_OFFER_LIST together. Each offer of the list is answered
+// with FIRMWARE_UPDATE_OFFER_DEFERRED; at the end of the list the decisions
+// are sent with ICompFwUpdateBspSendOfferResponse in component registration
+// order, so a host learns about every offer in one exchange.
+#ifndef CFU_OFFER_LIST
+#define CFU_OFFER_LIST                          (0)
+#endif
+
+// Largest number of offers in a list. Further offers are answered with
+// FIRMWARE_UPDATE_OFFER_BUSY.
+#ifndef CFU_OFFER_LIST_MAX
+#define CFU_OFFER_LIST_MAX                      (8)
+#endif
+
+// Number of components that can be updated at the same time, 1 to 4. Each
+// session holds its own copy of the per update state, including the write
+// buffers and erase bitmap.
+#ifndef CFU_MAX_SESSIONS
+#define CFU_MAX_SESSIONS                        (2)
+#endif
+
+// Persist a resume point while an image is staged so that a host can continue
+// an interrupted update instead of starting over with the first block. Needs
+// the ICompFwUpdateBspReadCheckpoint/WriteCheckpoint BSP hooks.
+#ifndef CFU_RESUMABLE_TRANSFER
+#define CFU_RESUMABLE_TRANSFER                  (0)
+#endif
+
+// Bytes of content between two stored resume points. Each one costs a write
+// to the checkpoint storage and waits for pages being programmed. Components
+// that coalesce writes get them further apart, at erase sector boundaries.
+#ifndef CFU_CHECKPOINT_INTERVAL
+#define CFU_CHECKPOINT_INTERVAL                 (4096)
+#endif
+
+// Set when the BSP implements BSP_Timer_Create/Stop/Restart (see
+// ICompFwUpdateBsp.h). Otherwise placeholders that never fire are used.
+#ifndef CFU_BSP_TIMER
+#define CFU_BSP_TIMER                           (0)
+#endif
+
+// Time without content after which an update session is abandoned, so that
+// a host that went away does not keep offers BUSY until the fail safe timer
+// fires. Components can override it in their registration. 0 disables the
+// inactivity timer.
+#ifndef CFU_INACTIVITY_TIMEOUT_MS
+#define CFU_INACTIVITY_TIMEOUT_MS               (5000)
+#endif
+
+// Period of the inactivity timer, i.e. the resolution of the timeouts
+#ifndef CFU_INACTIVITY_TICK_MS
+#define CFU_INACTIVITY_TICK_MS                  (250)
+#endif
+
+// Accept delta payloads: patches against the running image of a component
+// (see CFU_DELTA_OP_xxx), for components registered with
+// COMPONENT_FLAG_DELTA_PAYLOAD. Needs the ICompFwUpdateBspReadCurrent hook,
+// or ReadCurrent of the component's COMPONENT_STORAGE.
+#ifndef CFU_DELTA_PAYLOAD
+#define CFU_DELTA_PAYLOAD                       (0)
+#endif
+
+// Stack buffer used to copy from the running image, at most 255 bytes
+#ifndef CFU_DELTA_COPY_CHUNK
+#define CFU_DELTA_COPY_CHUNK                    (64)
+#endif
+
+// Accept compressed payloads (see CFU_COMPRESS_xxx) for components
+// registered with COMPONENT_FLAG_COMPRESSED_PAYLOAD.
+#ifndef CFU_COMPRESSED_PAYLOAD
+#define CFU_COMPRESSED_PAYLOAD                  (0)
+#endif
+
+// History kept by the decompressor of each session, a power of two. Hosts
+// must not refer further back than this.
+#ifndef CFU_COMPRESS_WINDOW
+#define CFU_COMPRESS_WINDOW                     (256)
+#endif
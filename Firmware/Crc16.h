@@ -0,0 +1,63 @@
+/*++
+    This file is part of Component Firmware Update (CFU), licensed under
+    the MIT License (MIT).
+
+    Copyright (c) Microsoft Corporation. All rights reserved.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+Module Name:
+
+    Crc16.h
+
+Abstract:
+
+    Table driven CRC16 used by the component firmware update engine.
+
+Environment:
+
+    Firmware driver.
+--*/
+#pragma once
+
+//****************************************************************************
+//
+//                               INCLUDES
+//
+//****************************************************************************
+#include "coretypes.h"
+
+//****************************************************************************
+//
+//                                  DEFINES
+//
+//****************************************************************************
+// CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF, no reflection
+// and no final XOR. The check value over "123456789" is 0x29B1.
+#define CRC16_INITIAL_VALUE                     (0xFFFFu)
+
+//****************************************************************************
+//
+//                          GLOBAL FUNCTION EXTERNS
+//
+//****************************************************************************
+
+// Continue a CRC16 computation over length bytes of pData. Start a new
+// computation by passing CRC16_INITIAL_VALUE as crc.
+UINT16 Crc16Update(UINT16 crc, const UINT8* pData, UINT32 length);
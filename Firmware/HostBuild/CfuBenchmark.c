@@ -0,0 +1,1668 @@
+/*++
+    This file is part of Component Firmware Update (CFU), licensed under
+    the MIT License (MIT).
+
+    Copyright (c) Microsoft Corporation. All rights reserved.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+Module Name:
+
+    CfuBenchmark.c
+
+Abstract:
+
+    Replays offer and content streams into the firmware core, running on
+    the RAM backed BSP, and reports the time spent per packet on the offer,
+    first block, middle block and last block paths.
+
+    Usage: cfubench [-n iterations] [-s image bytes] [-w content window]
+                    [-e erase ns per sector] [-p program ns per write] [-z] [-x]
+                    [-u] [-b] [-l]
+
+    -z sends the image compressed (requires CFU_COMPRESSED_PAYLOAD).
+    -x passes content reports to ProcessCFWUContentBuffer in place.
+    -u sends the blocks after the first one from the end of the image
+       backwards (requires CFU_UNORDERED_CONTENT).
+    -b has the image verified in the background, waiting for the result
+       with NOTIFY_ON_READY (requires CFU_BACKGROUND_VERIFY).
+    -l sends the offer in an offer list (requires CFU_OFFER_LIST).
+
+    With -w (at most CFU_CONTENT_WINDOW_MAX), one more update is sent after
+    the timed ones with blocks reordered, dropped and sent again, checking
+    the acknowledgement of every response.
+
+    Without CFU_STATIC_COMPONENTS, offers are then timed with 1, 8 and
+    MAX_REGISTERED_COMPONENTS components registered, and the GET_FWVERSION
+    pages are read and checked for each count.
+
+    Updates are then abandoned after a few blocks and freed by the
+    inactivity timeout (with CFU_INACTIVITY_TIMEOUT_MS) and by aborts,
+    checking the responses before and after.
+
+    Built with CFU_REGION_CHECK, blocks at the edges of the reserved region
+    and of the address space are sent and must be rejected.
+
+    Built with CFU_OFFER_LIST, a list of three offers is sent after the
+    timed updates, checking each decision and the order they come in.
+
+    Built with CFU_RESUMABLE_TRANSFER, one more update is interrupted by a
+    reset and resumed from the resume point the device reports, which is
+    checked against where the core should have put it.
+
+Environment:
+
+    Host build (Linux).
+--*/
+//****************************************************************************
+//
+//                               INCLUDES
+//
+//****************************************************************************
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "coretypes.h"
+#include "CfuComponents.h"
+#include "ComponentFwUpdate.h"
+#include "ComponentFwUpdateConfig.h"
+#include "Crc16.h"
+#include "IComponentFirmwareUpdate.h"
+#include "RamBsp.h"
+#include "Sha256.h"
+
+//****************************************************************************
+//
+//                                  DEFINES
+//
+//****************************************************************************
+// Payload of a content command in a 60 byte report, as the host tool sends
+#define BENCH_REPORT_SIZE                       (60)
+#define BENCH_BLOCK_SIZE                        (52)
+#define BENCH_TOKEN                             (0xA0)
+
+// Component that is never registered, offered by the offer list and version
+// page checks
+#define BENCH_UNKNOWN_COMPONENT                 (0x7F)
+
+// Offers timed for each component count of the dispatch check
+#define BENCH_DISPATCH_OFFERS                   (1000)
+
+// Ranges of the compare check are 1 << BENCH_COMPARE_SHIFT bytes, one sector
+#define BENCH_COMPARE_SHIFT                     (12)
+
+// Every BENCH_DROP_INTERVAL th block is lost the first time it is sent
+#define BENCH_DROP_INTERVAL                     (7)
+
+// Alignment of the block ends the core may make a resume point of, 0 for
+// none, see _UpdateCheckpoint. A component that coalesces writes needs lazy
+// erase and a sector boundary.
+#if CFU_WRITE_COALESCING && CFU_LAZY_ERASE
+#define BENCH_RESUME_ALIGNMENT                  (RAM_BSP_SECTOR_SIZE)
+#elif CFU_WRITE_COALESCING
+#define BENCH_RESUME_ALIGNMENT                  (0)
+#else
+#define BENCH_RESUME_ALIGNMENT                  (1)
+#endif
+
+// Longest literal run and match of the compressed format
+#define BENCH_MAX_LITERALS      (CFU_COMPRESS_TOKEN_MATCH)
+#define BENCH_MAX_MATCH         ((CFU_COMPRESS_TOKEN_MATCH - 1) + CFU_COMPRESS_MIN_MATCH)
+
+//****************************************************************************
+//
+//                                  TYPEDEFS
+//
+//****************************************************************************
+typedef struct
+{
+    UINT64 totalNs;
+    UINT32 packets;
+} BENCH_TIMING;
+
+//****************************************************************************
+//
+//                              STATIC VARIABLES
+//
+//****************************************************************************
+static UINT8        s_image[RAM_BSP_BANK_SIZE];
+// What is sent as content: the image, or the image compressed. Literal runs
+// make the compressed stream at most 1/128 larger than the image.
+static UINT8        s_stream[RAM_BSP_BANK_SIZE + RAM_BSP_BANK_SIZE / BENCH_MAX_LITERALS + 1];
+static UINT32       s_streamSize;
+static BOOL         s_zeroCopy;
+static BOOL         s_backgroundVerify;
+static BOOL         s_offerList;
+static UINT32       s_crcOffset;
+#if CFU_CONTENT_WINDOW_MAX
+// Blocks of the window check that were already lost once
+static UINT8        s_dropped[RAM_BSP_BANK_SIZE / BENCH_BLOCK_SIZE / 8 + 1];
+#endif
+static UINT8        s_digest[SHA256_DIGEST_SIZE];
+static BENCH_TIMING s_offerTiming;
+static BENCH_TIMING s_firstTiming;
+static BENCH_TIMING s_middleTiming;
+static BENCH_TIMING s_lastTiming;
+static BENCH_TIMING s_verifyTiming;
+
+//****************************************************************************
+//
+//                              GLOBAL VARIABLES
+//
+//****************************************************************************
+COMPONENT_REGION    g_benchRegions[BENCH_REGION_COUNT];
+
+//****************************************************************************
+//
+//                              FUNCTION CODE
+//
+//****************************************************************************
+MCU_STATUS BenchGetVersion(UINT32* pVersion)
+{
+    *pVersion = 0x01000000;
+    return MCU_STATUS_SUCCESS;
+}
+
+MCU_STATUS BenchGetProductInfo(UINT32* pProductInfo)
+{
+    *pProductInfo = 0;
+    return MCU_STATUS_SUCCESS;
+}
+
+MCU_STATUS BenchProcessOffer(FWUPDATE_OFFER_COMMAND* pCommand, FWUPDATE_OFFER_RESPONSE* pResponse)
+{
+    memset(pResponse, 0, sizeof(FWUPDATE_OFFER_RESPONSE));
+    pResponse->status = FIRMWARE_UPDATE_OFFER_ACCEPT;
+    pResponse->token = pCommand->componentInfo.token;
+    return MCU_STATUS_SUCCESS;
+}
+
+MCU_STATUS BenchGetCrcOffset(UINT32* pOffset)
+{
+    *pOffset = s_crcOffset;
+    return MCU_STATUS_SUCCESS;
+}
+
+MCU_STATUS BenchNotifySuccess(BOOL forceReset, READ_FIRMWARE_FUNC readHandler, READ_COMPLETED_FUNC readCompleteHandler)
+{
+    // A real component would now read the image out of the staging bank
+    readCompleteHandler();
+    return MCU_STATUS_SUCCESS;
+}
+
+#if !CFU_STATIC_COMPONENTS
+// Registration of a component with the callbacks and memory of the bench
+// component
+#define BENCH_REGISTRATION(componentId)                                     \
+{                                                                           \
+    NULL,                                                                   \
+    {                                                                       \
+        BenchGetVersion,                                                    \
+        BenchGetProductInfo,                                                \
+        BenchProcessOffer,                                                  \
+        BenchGetCrcOffset,                                                  \
+        BenchNotifySuccess,                                                 \
+    },                                                                      \
+    (componentId),                                                          \
+    BENCH_COMPONENT_FLAGS,                                                  \
+    RAM_BSP_PAGE_SIZE,                                                      \
+    RAM_BSP_SECTOR_SIZE,                                                    \
+    0,                                                                      \
+    0,                                                                      \
+    g_benchRegions,                                                         \
+    BENCH_REGION_COUNT,                                                     \
+    &g_ramBspStorage,                                                       \
+}
+
+static COMPONENT_REGISTRATION s_component = BENCH_REGISTRATION(BSP_YOURCOMPONENT);
+
+// Registered by the dispatch check after the bench component, with the
+// componentIds that follow BSP_YOURCOMPONENT. The members are const, so
+// each is copied in from an initialized registration.
+static COMPONENT_REGISTRATION s_otherComponents[MAX_REGISTERED_COMPONENTS - 1];
+#endif
+
+static UINT64 _NowNs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (UINT64)now.tv_sec * 1000000000ULL + (UINT64)now.tv_nsec;
+}
+
+static void _Fail(const char* pWhat, UINT32 status)
+{
+    fprintf(stderr, "cfubench: %s failed with status 0x%02X\n", pWhat, (unsigned int)status);
+    exit(1);
+}
+
+//****************************************************************************
+//
+// _BuildImage - Fill the image with a pseudo random pattern, embed its
+//               CRC in the last two bytes and take its SHA-256. Like a real
+//               image, its last quarter is unused and left erased. Describe
+//               it in the region table.
+//
+// Input Parameters
+//      UINT32 imageSize - Size of the image.
+//
+//****************************************************************************
+static void _BuildImage(UINT32 imageSize)
+{
+    UINT32 seed = 0x12345678;
+    UINT32 i;
+    UINT16 crc;
+    SHA256_CONTEXT context;
+
+    for (i = 0; i < imageSize; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        s_image[i] = (i < (imageSize - imageSize / 4)) ? (UINT8)(seed >> 16) : 0xFF;
+    }
+
+    s_crcOffset = imageSize - sizeof(UINT16);
+    crc = Crc16Update(CRC16_INITIAL_VALUE, s_image, s_crcOffset);
+    memcpy(&s_image[s_crcOffset], &crc, sizeof(crc));
+
+    g_benchRegions[0].start = 0;
+    g_benchRegions[0].end = s_crcOffset;
+    g_benchRegions[0].type = COMPONENT_REGION_WRITABLE;
+    g_benchRegions[1].start = s_crcOffset;
+    g_benchRegions[1].end = imageSize;
+    g_benchRegions[1].type = COMPONENT_REGION_CRC;
+    g_benchRegions[2].start = imageSize;
+    g_benchRegions[2].end = RAM_BSP_BANK_SIZE;
+    g_benchRegions[2].type = COMPONENT_REGION_RESERVED;
+
+    Sha256Init(&context);
+    Sha256Update(&context, s_image, imageSize);
+    Sha256Final(&context, s_digest);
+}
+
+//****************************************************************************
+//
+// _CompressImage - Compress the image into s_stream with a greedy search
+//                  for the longest match within CFU_COMPRESS_WINDOW.
+//
+// Input Parameters
+//      UINT32 imageSize - Size of the image.
+//
+//****************************************************************************
+static void _CompressImage(UINT32 imageSize)
+{
+    UINT32 literalStart = 0;
+    UINT32 position = 0;
+
+    s_streamSize = 0;
+
+    while (position <= imageSize)
+    {
+        UINT32 bestLength = 0;
+        UINT32 bestDistance = 0;
+        UINT32 distance;
+
+        for (distance = 1; (distance <= CFU_COMPRESS_WINDOW) && (distance <= position); distance++)
+        {
+            UINT32 length = 0;
+
+            while ((length < BENCH_MAX_MATCH) && ((position + length) < imageSize) &&
+                   (s_image[position + length] == s_image[position + length - distance]))
+            {
+                length++;
+            }
+
+            if (length > bestLength)
+            {
+                bestLength = length;
+                bestDistance = distance;
+            }
+        }
+
+        // Flush the pending literals before a match, when the run is full
+        // and at the end of the image.
+        if ((bestLength >= CFU_COMPRESS_MIN_MATCH) ||
+            ((position - literalStart) == BENCH_MAX_LITERALS) || (position == imageSize))
+        {
+            if (position > literalStart)
+            {
+                s_stream[s_streamSize++] = (UINT8)(position - literalStart - 1);
+                memcpy(&s_stream[s_streamSize], &s_image[literalStart], position - literalStart);
+                s_streamSize += position - literalStart;
+            }
+
+            literalStart = position;
+        }
+
+        if (position == imageSize)
+        {
+            break;
+        }
+
+        if (bestLength >= CFU_COMPRESS_MIN_MATCH)
+        {
+            s_stream[s_streamSize++] = (UINT8)(CFU_COMPRESS_TOKEN_MATCH |
+                                               (bestLength - CFU_COMPRESS_MIN_MATCH));
+            s_stream[s_streamSize++] = (UINT8)bestDistance;
+            s_stream[s_streamSize++] = (UINT8)(bestDistance >> 8);
+            position += bestLength;
+            literalStart = position;
+        }
+        else
+        {
+            position++;
+        }
+    }
+}
+
+//****************************************************************************
+//
+// _ProcessBlock - Send one content block of s_stream and time it, whatever
+//                 its response.
+//
+// Input Parameters
+//      UINT32 block - Index of the block in the stream.
+//      UINT32 blockCount - Number of blocks in the stream.
+//      FWUPDATE_CONTENT_RESPONSE* pResponse - The response received.
+//
+// Return
+//      Time spent in ProcessCFWUContent.
+//
+//****************************************************************************
+static UINT64 _ProcessBlock(UINT32 block, UINT32 blockCount, FWUPDATE_CONTENT_RESPONSE* pResponse)
+{
+    // Either a whole command, or a report as the transport received it
+    FWUPDATE_CONTENT_COMMAND command;
+    UINT8 report[BENCH_REPORT_SIZE];
+    FWUPDATE_CONTENT_COMMAND* pCommand = s_zeroCopy ? (FWUPDATE_CONTENT_COMMAND*)report : &command;
+    UINT32 address = block * BENCH_BLOCK_SIZE;
+    UINT32 length = s_streamSize - address;
+    UINT64 start;
+    UINT64 end;
+
+    if (length > BENCH_BLOCK_SIZE)
+    {
+        length = BENCH_BLOCK_SIZE;
+    }
+
+    pCommand->flags = 0;
+    pCommand->flags |= (block == 0) ? FIRMWARE_UPDATE_FLAG_FIRST_BLOCK : 0;
+    pCommand->flags |= (block == (blockCount - 1)) ? FIRMWARE_UPDATE_FLAG_LAST_BLOCK : 0;
+    pCommand->length = (UINT8)length;
+    pCommand->sequenceNumber = (UINT16)block;
+    pCommand->address = address;
+    memcpy(pCommand->pData, &s_stream[address], length);
+
+    start = _NowNs();
+
+    if (s_zeroCopy)
+    {
+        // The response goes back in the same report buffer
+        ProcessCFWUContentBuffer(report, sizeof(report), report);
+    }
+    else
+    {
+        ProcessCFWUContent(&command, pResponse);
+    }
+
+    end = _NowNs();
+
+    if (s_zeroCopy)
+    {
+        memcpy(pResponse, report, sizeof(FWUPDATE_CONTENT_RESPONSE));
+    }
+
+    return end - start;
+}
+
+//****************************************************************************
+//
+// _SendBlock - Send one content block of s_stream and time it. Fails unless
+//              it succeeds.
+//
+// Input Parameters
+//      UINT32 block - Index of the block in the stream.
+//      UINT32 blockCount - Number of blocks in the stream.
+//      FWUPDATE_CONTENT_RESPONSE* pResponse - The response received.
+//
+// Return
+//      Time spent in ProcessCFWUContent.
+//
+//****************************************************************************
+static UINT64 _SendBlock(UINT32 block, UINT32 blockCount, FWUPDATE_CONTENT_RESPONSE* pResponse)
+{
+    UINT64 ns = _ProcessBlock(block, blockCount, pResponse);
+
+    // Verified in the background, the last block is answered as pending
+    if ((pResponse->status != FIRMWARE_UPDATE_STATUS_SUCCESS) &&
+        !(s_backgroundVerify && (pResponse->status == FIRMWARE_UPDATE_STATUS_ERROR_PENDING)))
+    {
+        _Fail("content", pResponse->status);
+    }
+
+    return ns;
+}
+
+//****************************************************************************
+//
+// _WaitForVerification - Park on NOTIFY_ON_READY, run the background task as
+//                        the device would and check the deferred response.
+//
+//****************************************************************************
+static void _WaitForVerification(void)
+{
+    FWUPDATE_NOTIFY_OFFER_COMMAND notify;
+    FWUPDATE_NOTIFY_OFFER_RESPONSE response;
+    UINT64 start;
+
+    memset(&notify, 0, sizeof(notify));
+    notify.componentInfo.commandCode = CFU_SPECIAL_OFFER_NOTIFY_ON_READY;
+    notify.componentInfo.componentId = BSP_YOURCOMPONENT;
+    notify.componentInfo.shouldBe0xFE = CFU_SPECIAL_OFFER_CMD;
+    notify.componentInfo.token = BENCH_TOKEN;
+
+    ProcessCFWUOffer((FWUPDATE_OFFER_COMMAND*)&notify, (FWUPDATE_OFFER_RESPONSE*)&response);
+
+    if (response.status != FIRMWARE_UPDATE_OFFER_DEFERRED)
+    {
+        _Fail("notify", response.status);
+    }
+
+    start = _NowNs();
+    FirmwareUpdateBackgroundTask();
+    s_verifyTiming.totalNs += _NowNs() - start;
+    s_verifyTiming.packets++;
+
+    if (!RamBspGetOfferResponse((UINT8*)&response) ||
+        (response.status != FIRMWARE_UPDATE_OFFER_COMMAND_READY))
+    {
+        _Fail("deferred notify", response.status);
+    }
+
+    if (RamBspGetOfferResponse((UINT8*)&response))
+    {
+        _Fail("extra notify", response.status);
+    }
+
+    if (response.verifyStatus != FIRMWARE_UPDATE_STATUS_SUCCESS)
+    {
+        _Fail("verify", response.verifyStatus);
+    }
+}
+
+//****************************************************************************
+//
+// _SendOfferList - Send an offer between OFFER_INFO_START_OFFER_LIST and
+//                  OFFER_INFO_END_OFFER_LIST and collect its decision.
+//
+// Input Parameters
+//      FWUPDATE_OFFER_COMMAND* pOffer - The offer to send.
+//      FWUPDATE_OFFER_RESPONSE* pResponse - The decision.
+//
+//****************************************************************************
+static void _SendOfferList(FWUPDATE_OFFER_COMMAND* pOffer, FWUPDATE_OFFER_RESPONSE* pResponse)
+{
+    FWUPDATE_OFFER_INFO_ONLY_COMMAND info;
+    FWUPDATE_OFFER_RESPONSE response;
+
+    memset(&info, 0, sizeof(info));
+    info.componentInfo.infoCode = OFFER_INFO_START_OFFER_LIST;
+    info.componentInfo.shouldBe0xFF = CFU_OFFER_METADATA_INFO_CMD;
+    info.componentInfo.token = BENCH_TOKEN;
+    ProcessCFWUOffer((FWUPDATE_OFFER_COMMAND*)&info, &response);
+
+    if (response.status != FIRMWARE_UPDATE_OFFER_COMMAND_READY)
+    {
+        _Fail("start offer list", response.status);
+    }
+
+    ProcessCFWUOffer(pOffer, &response);
+
+    if (response.status != FIRMWARE_UPDATE_OFFER_DEFERRED)
+    {
+        _Fail("listed offer", response.status);
+    }
+
+    info.componentInfo.infoCode = OFFER_INFO_END_OFFER_LIST;
+    ProcessCFWUOffer((FWUPDATE_OFFER_COMMAND*)&info, &response);
+
+    if ((response.status != FIRMWARE_UPDATE_OFFER_COMMAND_READY) ||
+        !RamBspGetOfferResponse((UINT8*)pResponse) ||
+        (pResponse->componentId != pOffer->componentInfo.componentId) ||
+        RamBspGetOfferResponse((UINT8*)&response))
+    {
+        _Fail("end offer list", response.status);
+    }
+}
+
+#if CFU_OFFER_LIST
+//****************************************************************************
+//
+// _RunOfferListCheck - Send a list with an offer for a component that is not
+//                      registered followed by two offers for the bench
+//                      component, and check each decision and their order.
+//                      The bench component is decided first, in the order
+//                      it was offered. Its first offer is accepted, which
+//                      leaves the session busy for the other two.
+//
+// Return
+//      Number of decisions checked.
+//
+//****************************************************************************
+static UINT32 _RunOfferListCheck(void)
+{
+    // In the order the decisions should come, each offer has its own token
+    static const UINT8 componentIds[] =
+        { BSP_YOURCOMPONENT, BSP_YOURCOMPONENT, BENCH_UNKNOWN_COMPONENT };
+    static const UINT8 tokens[] = { BENCH_TOKEN + 1, BENCH_TOKEN + 2, BENCH_TOKEN };
+    static const UINT8 statuses[] =
+        { FIRMWARE_UPDATE_OFFER_ACCEPT, FIRMWARE_UPDATE_OFFER_BUSY, FIRMWARE_UPDATE_OFFER_BUSY };
+    static const UINT8 rejectReasonCodes[] =
+        { 0, FIRMWARE_UPDATE_OFFER_BUSY, FIRMWARE_UPDATE_OFFER_BUSY };
+    FWUPDATE_OFFER_INFO_ONLY_COMMAND info;
+    FWUPDATE_OFFER_COMMAND offer;
+    FWUPDATE_OFFER_RESPONSE response;
+    UINT32 i;
+
+    FirmwareUpdateInit();
+
+    memset(&info, 0, sizeof(info));
+    info.componentInfo.infoCode = OFFER_INFO_START_OFFER_LIST;
+    info.componentInfo.shouldBe0xFF = CFU_OFFER_METADATA_INFO_CMD;
+    info.componentInfo.token = BENCH_TOKEN;
+    ProcessCFWUOffer((FWUPDATE_OFFER_COMMAND*)&info, &response);
+
+    if (response.status != FIRMWARE_UPDATE_OFFER_COMMAND_READY)
+    {
+        _Fail("start offer list", response.status);
+    }
+
+    memset(&offer, 0, sizeof(offer));
+    offer.version = 0x01000001;
+
+    for (i = 0; i < 3; i++)
+    {
+        offer.componentInfo.componentId = i ? BSP_YOURCOMPONENT : BENCH_UNKNOWN_COMPONENT;
+        offer.componentInfo.token = (UINT8)(BENCH_TOKEN + i);
+        ProcessCFWUOffer(&offer, &response);
+
+        if (response.status != FIRMWARE_UPDATE_OFFER_DEFERRED)
+        {
+            _Fail("listed offer", response.status);
+        }
+    }
+
+    info.componentInfo.infoCode = OFFER_INFO_END_OFFER_LIST;
+    ProcessCFWUOffer((FWUPDATE_OFFER_COMMAND*)&info, &response);
+
+    if (response.status != FIRMWARE_UPDATE_OFFER_COMMAND_READY)
+    {
+        _Fail("end offer list", response.status);
+    }
+
+    for (i = 0; i < 3; i++)
+    {
+        if (!RamBspGetOfferResponse((UINT8*)&response))
+        {
+            _Fail("missing decision", i);
+        }
+
+        if ((response.componentId != componentIds[i]) || (response.token != tokens[i]) ||
+            (response.status != statuses[i]) ||
+            (response.rejectReasonCode != rejectReasonCodes[i]))
+        {
+            _Fail("decision", response.status);
+        }
+    }
+
+    if (RamBspGetOfferResponse((UINT8*)&response))
+    {
+        _Fail("extra decision", response.status);
+    }
+
+    // Drop the update the list started
+    FirmwareUpdateInit();
+
+    return i;
+}
+#endif
+
+//****************************************************************************
+//
+// _RunUpdate - Offer the image and send all of its content, as a host
+//              would after the device has started up.
+//
+// Input Parameters
+//      UINT8 contentWindow - Content window to request.
+//      BOOL compressed - Whether s_stream holds the image compressed.
+//      BOOL unordered - Send the blocks after the first one in reverse.
+//
+//****************************************************************************
+static void _RunUpdate(UINT8 contentWindow, BOOL compressed, BOOL unordered)
+{
+    FWUPDATE_OFFER_COMMAND offer;
+    FWUPDATE_OFFER_RESPONSE offerResponse;
+    FWUPDATE_CONTENT_RESPONSE response;
+    UINT32 blockCount = (s_streamSize + BENCH_BLOCK_SIZE - 1) / BENCH_BLOCK_SIZE;
+    UINT32 block;
+    UINT64 start;
+
+    // Start from a freshly booted engine, as after the bank swap of the
+    // previous update.
+    FirmwareUpdateInit();
+
+    memset(&offer, 0, sizeof(offer));
+    offer.componentInfo.componentId = BSP_YOURCOMPONENT;
+    offer.componentInfo.token = BENCH_TOKEN;
+    offer.componentInfo.contentWindow = contentWindow;
+    offer.version = 0x01000001;
+    offer.productInfo.compressedPayload = compressed;
+    offer.productInfo.unorderedContent = unordered;
+    offer.productInfo.backgroundVerify = s_backgroundVerify;
+
+    start = _NowNs();
+
+    if (s_offerList)
+    {
+        _SendOfferList(&offer, &offerResponse);
+    }
+    else
+    {
+        ProcessCFWUOffer(&offer, &offerResponse);
+    }
+
+    s_offerTiming.totalNs += _NowNs() - start;
+    s_offerTiming.packets += s_offerList ? 3 : 1;
+
+    if ((offerResponse.status != FIRMWARE_UPDATE_OFFER_ACCEPT) ||
+        (offerResponse.unorderedContent != (unordered && !CFU_WRITE_COALESCING)) ||
+        (offerResponse.backgroundVerify != s_backgroundVerify))
+    {
+        _Fail("offer", offerResponse.status);
+    }
+
+    // The bench component coalesces writes with CFU_WRITE_COALESCING and is
+    // then not granted out of order content.
+    unordered = offerResponse.unorderedContent;
+
+    s_firstTiming.totalNs += _SendBlock(0, blockCount, &response);
+    s_firstTiming.packets++;
+
+    // Out of order, the image is complete once block 1 is in and the
+    // "last block" timing is that of block 1.
+    for (block = 1; block < (blockCount - 1); block++)
+    {
+        s_middleTiming.totalNs += _SendBlock(unordered ? (blockCount - block) : block,
+                                             blockCount, &response);
+        s_middleTiming.packets++;
+    }
+
+    s_lastTiming.totalNs += _SendBlock(unordered ? 1 : (blockCount - 1), blockCount, &response);
+    s_lastTiming.packets++;
+
+    if (s_backgroundVerify)
+    {
+        _WaitForVerification();
+    }
+}
+
+#if CFU_CONTENT_WINDOW_MAX
+//****************************************************************************
+//
+// _CheckWindowedBlock - Send a block in windowed mode and check that the
+//                       acknowledgement is the one expected.
+//
+// Input Parameters
+//      UINT32 block - Index of the block in the stream.
+//      UINT32 blockCount - Number of blocks in the stream.
+//      UINT8 contentWindow - The granted content window.
+//      UINT16* pAck - Expected ackSequenceNumber, updated for the block.
+//      UINT32* pMask - Expected selectiveAckMask, updated for the block.
+//
+//****************************************************************************
+static void _CheckWindowedBlock(UINT32 block, UINT32 blockCount, UINT8 contentWindow, UINT16* pAck, UINT32* pMask)
+{
+    FWUPDATE_CONTENT_RESPONSE response;
+    UINT16 delta = (UINT16)(block - *pAck);
+
+    if ((delta != 0) && (delta <= contentWindow))
+    {
+        *pMask |= 1UL << (delta - 1);
+
+        while (*pMask & 1)
+        {
+            (*pAck)++;
+            *pMask >>= 1;
+        }
+    }
+
+    _SendBlock(block, blockCount, &response);
+
+    if ((response.sequenceNumber != (UINT16)block) ||
+        (response.ackSequenceNumber != *pAck) || (response.selectiveAckMask != *pMask))
+    {
+        fprintf(stderr, "cfubench: block %u acknowledged up to %u with mask 0x%08X, "
+                        "expected %u with 0x%08X\n", (unsigned int)block,
+                        response.ackSequenceNumber, (unsigned int)response.selectiveAckMask,
+                        *pAck, (unsigned int)*pMask);
+        exit(1);
+    }
+}
+
+//****************************************************************************
+//
+// _SendWindowedOffer - Offer the image for an update with a content window.
+//
+// Input Parameters
+//      UINT8 contentWindow - Content window to request.
+//
+// Return
+//      The granted content window.
+//
+//****************************************************************************
+static UINT8 _SendWindowedOffer(UINT8 contentWindow)
+{
+    FWUPDATE_OFFER_COMMAND offer;
+    FWUPDATE_OFFER_RESPONSE offerResponse;
+
+    memset(&offer, 0, sizeof(offer));
+    offer.componentInfo.componentId = BSP_YOURCOMPONENT;
+    offer.componentInfo.token = BENCH_TOKEN;
+    offer.componentInfo.contentWindow = contentWindow;
+    offer.version = 0x01000001;
+    offer.productInfo.backgroundVerify = s_backgroundVerify;
+
+    if (s_offerList)
+    {
+        _SendOfferList(&offer, &offerResponse);
+    }
+    else
+    {
+        ProcessCFWUOffer(&offer, &offerResponse);
+    }
+
+    if (offerResponse.status != FIRMWARE_UPDATE_OFFER_ACCEPT)
+    {
+        _Fail("windowed offer", offerResponse.status);
+    }
+
+    return offerResponse.contentWindow;
+}
+
+//****************************************************************************
+//
+// _RunWindowCheck - Send an update in windowed mode as a host would over a
+//                   lossy link: each round sends the blocks of the window
+//                   that are not acknowledged yet, last one first, and every
+//                   BENCH_DROP_INTERVAL th block is lost the first time. The
+//                   last acknowledged block is sent again each round, as if
+//                   its response had been lost. The lost blocks are sent
+//                   again in the following rounds. A block beyond the window
+//                   sent first must end the update. The bench component
+//                   coalesces writes with CFU_WRITE_COALESCING and must then
+//                   be granted no window.
+//
+// Input Parameters
+//      UINT8 contentWindow - Content window to request.
+//      UINT32* pDropped - Number of blocks lost.
+//
+// Return
+//      Number of blocks sent, 0 if no window was granted.
+//
+//****************************************************************************
+static UINT32 _RunWindowCheck(UINT8 contentWindow, UINT32* pDropped)
+{
+    FWUPDATE_CONTENT_RESPONSE response;
+    UINT32 blockCount = (s_streamSize + BENCH_BLOCK_SIZE - 1) / BENCH_BLOCK_SIZE;
+    UINT32 sends = 0;
+    UINT16 ack = 0;
+    UINT32 mask = 0;
+
+    FirmwareUpdateInit();
+    memset(s_dropped, 0, sizeof(s_dropped));
+    *pDropped = 0;
+
+    if (_SendWindowedOffer(contentWindow) != (CFU_WRITE_COALESCING ? 0 : contentWindow))
+    {
+        _Fail("granted window", contentWindow);
+    }
+
+    if (CFU_WRITE_COALESCING)
+    {
+        FirmwareUpdateInit();
+        return 0;
+    }
+
+    if ((UINT32)contentWindow + 1 < blockCount)
+    {
+        _SendBlock(0, blockCount, &response);
+        _ProcessBlock(contentWindow + 1, blockCount, &response);
+
+        if ((response.status != FIRMWARE_UPDATE_STATUS_ERROR_INVALID) ||
+            (response.sequenceNumber != (UINT16)(contentWindow + 1)))
+        {
+            _Fail("block beyond the window", response.status);
+        }
+
+        _SendWindowedOffer(contentWindow);
+    }
+
+    _CheckWindowedBlock(0, blockCount, contentWindow, &ack, &mask);
+    sends++;
+
+    while (ack != (UINT16)(blockCount - 1))
+    {
+        UINT32 block = ack + contentWindow;
+        UINT32 first = ack + 1;
+
+        // The first block would start the image over
+        if (ack != 0)
+        {
+            _CheckWindowedBlock(ack, blockCount, contentWindow, &ack, &mask);
+            sends++;
+        }
+
+        if (block >= blockCount)
+        {
+            block = blockCount - 1;
+        }
+
+        for (; block >= first; block--)
+        {
+            UINT8 bit = (UINT8)(1u << (block & 7));
+
+            if ((block <= ack) || (mask & (1UL << (block - ack - 1))))
+            {
+                // Already acknowledged
+                continue;
+            }
+
+            if (((block % BENCH_DROP_INTERVAL) == 0) && !(s_dropped[block >> 3] & bit))
+            {
+                s_dropped[block >> 3] |= bit;
+                (*pDropped)++;
+                continue;
+            }
+
+            _CheckWindowedBlock(block, blockCount, contentWindow, &ack, &mask);
+            sends++;
+        }
+    }
+
+    if (s_backgroundVerify)
+    {
+        _WaitForVerification();
+    }
+
+    return sends;
+}
+#endif
+
+//****************************************************************************
+//
+// _SendOffer - Offer the image for an update without a window, in an offer
+//              list with -l so that NOTIFY_ON_READY is deferred as in the
+//              timed updates.
+//
+// Input Parameters
+//      UINT8 status - FIRMWARE_UPDATE_OFFER_xxx the offer must be answered
+//                     with.
+//
+//****************************************************************************
+static void _SendOffer(UINT8 status)
+{
+    FWUPDATE_OFFER_COMMAND offer;
+    FWUPDATE_OFFER_RESPONSE response;
+
+    memset(&offer, 0, sizeof(offer));
+    offer.componentInfo.componentId = BSP_YOURCOMPONENT;
+    offer.componentInfo.token = BENCH_TOKEN;
+    offer.version = 0x01000001;
+    offer.productInfo.backgroundVerify = s_backgroundVerify;
+
+    if (s_offerList)
+    {
+        _SendOfferList(&offer, &response);
+    }
+    else
+    {
+        ProcessCFWUOffer(&offer, &response);
+    }
+
+    if ((response.status != status) || (response.token != BENCH_TOKEN))
+    {
+        _Fail("offer", response.status);
+    }
+}
+
+#if CFU_RESUMABLE_TRANSFER
+//****************************************************************************
+//
+// _RunResumeCheck - Interrupt an update with a reset once 7/8 of its blocks
+//                   are sent, then resume it as a host would: ask for the
+//                   resume point, offer the image again and send the blocks
+//                   that follow it, or all of them if there is none.
+//
+// Input Parameters
+//      UINT32* pInterrupted - Number of blocks sent before the reset.
+//
+// Return
+//      The block the update was resumed from.
+//
+//****************************************************************************
+static UINT32 _RunResumeCheck(UINT32* pInterrupted)
+{
+    FWUPDATE_RESUME_OFFER_COMMAND command;
+    FWUPDATE_RESUME_OFFER_RESPONSE response;
+    FWUPDATE_CONTENT_RESPONSE contentResponse;
+    UINT32 blockCount = (s_streamSize + BENCH_BLOCK_SIZE - 1) / BENCH_BLOCK_SIZE;
+    UINT32 interrupted = blockCount - blockCount / 8;
+    UINT32 checkpointAddress = 0;
+    UINT32 resumeBlock = 0;
+    UINT32 block;
+
+    FirmwareUpdateInit();
+    _SendOffer(FIRMWARE_UPDATE_OFFER_ACCEPT);
+
+    for (block = 0; block < interrupted; block++)
+    {
+        _SendBlock(block, blockCount, &contentResponse);
+
+        if (contentResponse.sequenceNumber != (UINT16)block)
+        {
+            _Fail("content sequence", contentResponse.sequenceNumber);
+        }
+
+        // Where the core should have moved the resume point to. Neither
+        // the first nor the last block is one.
+        if ((block != 0) && BENCH_RESUME_ALIGNMENT &&
+            ((((block + 1) * BENCH_BLOCK_SIZE) - checkpointAddress) >= CFU_CHECKPOINT_INTERVAL) &&
+            ((((block + 1) * BENCH_BLOCK_SIZE) & (BENCH_RESUME_ALIGNMENT - 1)) == 0))
+        {
+            checkpointAddress = (block + 1) * BENCH_BLOCK_SIZE;
+            resumeBlock = block + 1;
+        }
+    }
+
+    // The device resets, losing anything that was not programmed
+    FirmwareUpdateInit();
+
+    memset(&command, 0, sizeof(command));
+    command.componentInfo.commandCode = CFU_SPECIAL_OFFER_GET_RESUME_POINT;
+    command.componentInfo.componentId = BSP_YOURCOMPONENT;
+    command.componentInfo.shouldBe0xFE = CFU_SPECIAL_OFFER_CMD;
+    command.componentInfo.token = BENCH_TOKEN;
+    command.version = 0x01000001;
+    ProcessCFWUOffer((FWUPDATE_OFFER_COMMAND*)&command, (FWUPDATE_OFFER_RESPONSE*)&response);
+
+    if ((resumeBlock != 0) &&
+        ((response.status != FIRMWARE_UPDATE_OFFER_COMMAND_READY) ||
+         (response.sequenceNumber != (UINT16)(resumeBlock - 1)) ||
+         (response.address != checkpointAddress)))
+    {
+        fprintf(stderr, "cfubench: resume point 0x%02X block %u at %u, expected block %u at %u\n",
+                response.status, response.sequenceNumber, (unsigned int)response.address,
+                (unsigned int)(resumeBlock - 1), (unsigned int)checkpointAddress);
+        exit(1);
+    }
+
+    if ((resumeBlock == 0) &&
+        ((response.status != FIRMWARE_UPDATE_OFFER_REJECT) ||
+         (response.rejectReasonCode != FIRMWARE_OFFER_REJECT_MISMATCH)))
+    {
+        _Fail("missing resume point", response.status);
+    }
+
+    _SendOffer(FIRMWARE_UPDATE_OFFER_ACCEPT);
+
+    for (block = resumeBlock; block < blockCount; block++)
+    {
+        _SendBlock(block, blockCount, &contentResponse);
+
+        if (contentResponse.sequenceNumber != (UINT16)block)
+        {
+            _Fail("resumed content sequence", contentResponse.sequenceNumber);
+        }
+    }
+
+    if (s_backgroundVerify)
+    {
+        _WaitForVerification();
+    }
+
+    *pInterrupted = interrupted;
+    return resumeBlock;
+}
+#endif
+
+//****************************************************************************
+//
+// _RunAbandonCheck - Abandon three updates after their first blocks, as a
+//                    host that went away would, and free them: by the
+//                    inactivity timeout (with CFU_INACTIVITY_TIMEOUT_MS), by
+//                    aborting the component and by aborting every session.
+//                    Offers are busy until then. Content sent afterwards is
+//                    answered ERROR_NO_OFFER with its sequence number, and
+//                    the image can be offered again.
+//
+// Return
+//      Number of updates freed.
+//
+//****************************************************************************
+static UINT32 _RunAbandonCheck(void)
+{
+    static const UINT8 abortIds[] = { 0, BSP_YOURCOMPONENT, CFU_SPECIAL_OFFER_ABORT_ALL };
+    FWUPDATE_ABORT_OFFER_COMMAND abort;
+    FWUPDATE_OFFER_RESPONSE response;
+    FWUPDATE_CONTENT_RESPONSE contentResponse;
+    UINT32 blockCount = (s_streamSize + BENCH_BLOCK_SIZE - 1) / BENCH_BLOCK_SIZE;
+    UINT32 freed = 0;
+    UINT32 i;
+
+    FirmwareUpdateInit();
+
+    memset(&abort, 0, sizeof(abort));
+    abort.componentInfo.commandCode = CFU_SPECIAL_OFFER_ABORT;
+    abort.componentInfo.shouldBe0xFE = CFU_SPECIAL_OFFER_CMD;
+    abort.componentInfo.token = BENCH_TOKEN;
+
+    for (i = 0; i < sizeof(abortIds); i++)
+    {
+#if !CFU_INACTIVITY_TIMEOUT_MS
+        if (abortIds[i] == 0)
+        {
+            continue;
+        }
+
+#endif
+        _SendOffer(FIRMWARE_UPDATE_OFFER_ACCEPT);
+        _SendBlock(0, blockCount, &contentResponse);
+        _SendBlock(1, blockCount, &contentResponse);
+
+        if (contentResponse.sequenceNumber != 1)
+        {
+            _Fail("sequence number", contentResponse.sequenceNumber);
+        }
+
+        _SendOffer(FIRMWARE_UPDATE_OFFER_BUSY);
+
+        if (abortIds[i] != 0)
+        {
+            abort.componentInfo.componentId = abortIds[i];
+            ProcessCFWUOffer((FWUPDATE_OFFER_COMMAND*)&abort, &response);
+
+            if ((response.status != FIRMWARE_UPDATE_OFFER_COMMAND_READY) ||
+                (response.token != BENCH_TOKEN))
+            {
+                _Fail("abort", response.status);
+            }
+        }
+#if CFU_INACTIVITY_TIMEOUT_MS
+        else
+        {
+            // The session outlives every tick but the last
+            RamBspAdvanceTime(CFU_INACTIVITY_TIMEOUT_MS - CFU_INACTIVITY_TICK_MS);
+            _SendOffer(FIRMWARE_UPDATE_OFFER_BUSY);
+            RamBspAdvanceTime(CFU_INACTIVITY_TICK_MS);
+        }
+#endif
+
+        _ProcessBlock(2, blockCount, &contentResponse);
+
+        if ((contentResponse.status != FIRMWARE_UPDATE_STATUS_ERROR_NO_OFFER) ||
+            (contentResponse.sequenceNumber != 2))
+        {
+            _Fail("abandoned content", contentResponse.status);
+        }
+
+        freed++;
+    }
+
+    _SendOffer(FIRMWARE_UPDATE_OFFER_ACCEPT);
+    FirmwareUpdateInit();
+
+    return freed;
+}
+
+#if CFU_REGION_CHECK
+//****************************************************************************
+//
+// _RunRegionCheck - Send blocks at the edges of the bench regions after the
+//                   first block of an update: across the end of the image
+//                   into the reserved region, at its start, past the last
+//                   region and wrapping around the address space. Each must
+//                   be answered ERROR_INVALID_ADDR with its sequence number
+//                   and end the update, so the image can be offered again.
+//
+// Return
+//      Number of blocks rejected.
+//
+//****************************************************************************
+static UINT32 _RunRegionCheck(void)
+{
+    const COMPONENT_REGION* pReserved = &g_benchRegions[BENCH_REGION_COUNT - 1];
+    const UINT32 addresses[] =
+    {
+        pReserved->start - BENCH_BLOCK_SIZE / 2,
+        pReserved->start,
+        pReserved->end - BENCH_BLOCK_SIZE / 2,
+        (UINT32)0 - BENCH_BLOCK_SIZE / 2,
+    };
+    FWUPDATE_CONTENT_COMMAND command;
+    FWUPDATE_CONTENT_RESPONSE response;
+    UINT32 blockCount = (s_streamSize + BENCH_BLOCK_SIZE - 1) / BENCH_BLOCK_SIZE;
+    UINT32 i;
+
+    memset(&command, 0xA5, sizeof(command));
+    command.flags = 0;
+    command.length = BENCH_BLOCK_SIZE;
+
+    for (i = 0; i < sizeof(addresses) / sizeof(addresses[0]); i++)
+    {
+        FirmwareUpdateInit();
+        _SendOffer(FIRMWARE_UPDATE_OFFER_ACCEPT);
+        _SendBlock(0, blockCount, &response);
+
+        command.sequenceNumber = (UINT16)(1 + i);
+        command.address = addresses[i];
+        ProcessCFWUContent(&command, &response);
+
+        if ((response.status != FIRMWARE_UPDATE_STATUS_ERROR_INVALID_ADDR) ||
+            (response.sequenceNumber != command.sequenceNumber))
+        {
+            _Fail("region edge", response.status);
+        }
+
+        _SendOffer(FIRMWARE_UPDATE_OFFER_ACCEPT);
+    }
+
+    FirmwareUpdateInit();
+
+    return i;
+}
+#endif
+
+#if CFU_RANGE_COMPARE
+//****************************************************************************
+//
+// _RunCompareCheck - Compare the first two ranges of the staged image in a
+//                    content command flagged FIRMWARE_UPDATE_FLAG_COMPARE:
+//                    the first with the hash of the image, which must match,
+//                    and the second with the hash of a copy with one byte
+//                    changed, which must not.
+//
+// Return
+//      Number of ranges compared.
+//
+//****************************************************************************
+static UINT32 _RunCompareCheck(void)
+{
+    FWUPDATE_CONTENT_COMMAND command;
+    FWUPDATE_CONTENT_RESPONSE response;
+    FWUPDATE_COMPARE_CONTENT* pCompare = (FWUPDATE_COMPARE_CONTENT*)command.pData;
+    UINT32 rangeSize = 1UL << BENCH_COMPARE_SHIFT;
+    UINT8 stale[1UL << BENCH_COMPARE_SHIFT];
+    UINT8 digest[SHA256_DIGEST_SIZE];
+    SHA256_CONTEXT context;
+
+    memset(&command, 0, sizeof(command));
+    command.flags = FIRMWARE_UPDATE_FLAG_COMPARE;
+    command.length = (UINT8)(offsetof(FWUPDATE_COMPARE_CONTENT, hash) + 2 * CFU_COMPARE_HASH_SIZE);
+    command.sequenceNumber = 0x1234;
+    pCompare->componentId = BSP_YOURCOMPONENT;
+    pCompare->rangeShift = BENCH_COMPARE_SHIFT;
+    pCompare->firstRange = 0;
+
+    Sha256Init(&context);
+    Sha256Update(&context, s_image, rangeSize);
+    Sha256Final(&context, digest);
+    memcpy(pCompare->hash[0], digest, CFU_COMPARE_HASH_SIZE);
+
+    memcpy(stale, &s_image[rangeSize], rangeSize);
+    stale[rangeSize / 2] ^= 0x01;
+    Sha256Init(&context);
+    Sha256Update(&context, stale, rangeSize);
+    Sha256Final(&context, digest);
+    memcpy(pCompare->hash[1], digest, CFU_COMPARE_HASH_SIZE);
+
+    ProcessCFWUContent(&command, &response);
+
+    if ((response.status != FIRMWARE_UPDATE_STATUS_SUCCESS) ||
+        (response.sequenceNumber != 0x1234) || (response.selectiveAckMask != 0x1))
+    {
+        _Fail("compare", response.status);
+    }
+
+    return 2;
+}
+#endif
+
+static void _Report(const char* pName, BENCH_TIMING* pTiming)
+{
+    printf("%-14s %12.1f ns/packet\n", pName,
+           pTiming->packets ? (double)pTiming->totalNs / pTiming->packets : 0.0);
+}
+
+#if !CFU_STATIC_COMPONENTS
+//****************************************************************************
+//
+// _CheckVersionPages - Read the GET_FWVERSION pages as a host would, until
+//                      one comes back without extensionFlag, and check the
+//                      header and blob of each. The next read, and a read
+//                      after an offer, must start over at page 0. One more
+//                      page past the end must be empty.
+//
+// Input Parameters
+//      UINT8 registered - Number of registered components, all with the
+//                         version and product info of the bench component.
+//
+// Return
+//      Number of pages read before the empty one.
+//
+//****************************************************************************
+static UINT32 _CheckVersionPages(UINT8 registered)
+{
+    FWUPDATE_OFFER_COMMAND offer;
+    FWUPDATE_OFFER_RESPONSE offerResponse;
+    GET_FWVERSION_RESPONSE response;
+    UINT32 expectedBlob[2 * CFU_FWVERSION_COMPONENTS_PER_PAGE];
+    UINT32 pageCount = 0;
+    UINT32 reported = 0;
+    UINT32 i;
+
+    do
+    {
+        UINT8 componentCount = ((registered - reported) < CFU_FWVERSION_COMPONENTS_PER_PAGE) ?
+            (UINT8)(registered - reported) : (UINT8)CFU_FWVERSION_COMPONENTS_PER_PAGE;
+
+        ProcessCFWUGetFWVersion(&response);
+
+        memset(expectedBlob, 0, sizeof(expectedBlob));
+        for (i = 0; i < componentCount; i++)
+        {
+            BenchGetVersion(&expectedBlob[2 * i]);
+            BenchGetProductInfo(&expectedBlob[2 * i + 1]);
+        }
+
+        if ((response.header.componentCount != componentCount) ||
+            (response.header.firstComponent != reported) ||
+            (response.header.extensionFlag != ((reported + componentCount) < registered)) ||
+            (memcmp(response.versionAndProductInfoBlob, expectedBlob, sizeof(expectedBlob)) != 0))
+        {
+            _Fail("version page", pageCount);
+        }
+
+        reported += componentCount;
+        pageCount++;
+    } while (response.header.extensionFlag);
+
+    // A read after the last page, and one after any offer, is page 0
+    memset(&offer, 0, sizeof(offer));
+    offer.componentInfo.componentId = BENCH_UNKNOWN_COMPONENT;
+    offer.componentInfo.token = BENCH_TOKEN;
+
+    for (i = 0; i < 2; i++)
+    {
+        ProcessCFWUGetFWVersion(&response);
+
+        if ((response.header.firstComponent != 0) || (response.header.componentCount == 0))
+        {
+            _Fail("version page after the last", pageCount);
+        }
+
+        ProcessCFWUOffer(&offer, &offerResponse);
+    }
+
+    ProcessCFWUGetFWVersionPage((UINT8)pageCount, &response);
+
+    if ((reported != registered) || (response.header.componentCount != 0) ||
+        response.header.extensionFlag)
+    {
+        _Fail("version page past the end", pageCount);
+    }
+
+    return pageCount;
+}
+
+//****************************************************************************
+//
+// _RunDispatchCheck - Time offers with 1, 8 and MAX_REGISTERED_COMPONENTS
+//                     components registered. Each offer is for the component
+//                     registered last and is accepted, so it covers the
+//                     lookup of the component and its session. The cost
+//                     should not grow with the number of components. The
+//                     GET_FWVERSION pages are checked for each count too.
+//
+//****************************************************************************
+static void _RunDispatchCheck(void)
+{
+    static const UINT8 componentCounts[] = { 1, 8, MAX_REGISTERED_COMPONENTS };
+    FWUPDATE_OFFER_COMMAND offer;
+    FWUPDATE_OFFER_RESPONSE response;
+    UINT8 registered = 1;
+    UINT32 i;
+    UINT32 j;
+
+    memset(&offer, 0, sizeof(offer));
+    offer.componentInfo.token = BENCH_TOKEN;
+    offer.version = 0x01000001;
+
+    for (i = 0; i < sizeof(componentCounts); i++)
+    {
+        UINT64 totalNs = 0;
+
+        if (componentCounts[i] > MAX_REGISTERED_COMPONENTS)
+        {
+            continue;
+        }
+
+        for (; registered < componentCounts[i]; registered++)
+        {
+            COMPONENT_REGISTRATION component =
+                BENCH_REGISTRATION((UINT8)(BSP_YOURCOMPONENT + registered));
+
+            memcpy(&s_otherComponents[registered - 1], &component, sizeof(component));
+            IComponentFirmwareUpdateRegisterComponent(&s_otherComponents[registered - 1]);
+        }
+
+        offer.componentInfo.componentId = (UINT8)(BSP_YOURCOMPONENT + registered - 1);
+
+        for (j = 0; j < BENCH_DISPATCH_OFFERS; j++)
+        {
+            UINT64 start;
+
+            // Drops the update the previous offer started
+            FirmwareUpdateInit();
+
+            start = _NowNs();
+            ProcessCFWUOffer(&offer, &response);
+            totalNs += _NowNs() - start;
+
+            if (response.status != FIRMWARE_UPDATE_OFFER_ACCEPT)
+            {
+                _Fail("dispatch offer", response.status);
+            }
+        }
+
+        printf("offer with %2u components %8.1f ns/offer, %u version pages\n",
+               (unsigned int)registered, (double)totalNs / BENCH_DISPATCH_OFFERS,
+               (unsigned int)_CheckVersionPages(registered));
+    }
+
+    FirmwareUpdateInit();
+}
+#endif
+
+#if CFU_TIMING_STATS
+//****************************************************************************
+//
+// _ReportPhases - Print the on-device timing of the last update, as host
+//                 tooling would read it with ProcessCFWUGetTiming.
+//
+//****************************************************************************
+static void _ReportPhases(void)
+{
+    static const char* const s_phaseNames[CFU_TIMING_PHASE_COUNT] =
+    {
+        "offer", "prepare", "erase", "write", "crc", "authenticate", "notify",
+    };
+    UINT8 phase;
+
+    printf("last update    %8s %12s %12s %12s ticks\n", "calls", "min", "max", "total");
+
+    for (phase = 0; phase < CFU_TIMING_PHASE_COUNT; phase++)
+    {
+        GET_TIMING_RESPONSE timing;
+
+        ProcessCFWUGetTiming(BSP_YOURCOMPONENT, phase, &timing);
+        printf("  %-12s %8u %12u %12u %12llu\n", s_phaseNames[phase],
+               (unsigned int)timing.count, (unsigned int)timing.minTicks,
+               (unsigned int)timing.maxTicks, timing.totalTicks);
+    }
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    RAM_BSP_CONFIG config;
+    RAM_BSP_STATS stats;
+    UINT32 iterations = 100;
+    UINT32 imageSize = 64 * 1024;
+    UINT32 contentWindow = 0;
+#if CFU_CONTENT_WINDOW_MAX
+    UINT32 windowSends = 0;
+    UINT32 windowDropped = 0;
+#endif
+#if CFU_OFFER_LIST
+    UINT32 decisions;
+#endif
+    UINT32 freed;
+#if CFU_REGION_CHECK
+    UINT32 rejected;
+#endif
+#if CFU_RANGE_COMPARE
+    UINT32 compared = 0;
+#endif
+#if CFU_RESUMABLE_TRANSFER
+    UINT32 resumeBlock = 0;
+    UINT32 interrupted = 0;
+#endif
+    BOOL compressed = FALSE;
+    BOOL unordered = FALSE;
+    UINT32 i;
+    int option;
+
+    memset(&config, 0, sizeof(config));
+
+    while ((option = getopt(argc, argv, "n:s:w:e:p:zxubl")) != -1)
+    {
+        switch (option)
+        {
+        case 'n': iterations = strtoul(optarg, NULL, 0); break;
+        case 's': imageSize = strtoul(optarg, NULL, 0); break;
+        case 'w': contentWindow = strtoul(optarg, NULL, 0); break;
+        case 'e': config.eraseLatencyNs = strtoul(optarg, NULL, 0); break;
+        case 'p': config.programLatencyNs = strtoul(optarg, NULL, 0); break;
+        case 'z': compressed = TRUE; break;
+        case 'x': s_zeroCopy = TRUE; break;
+        case 'u': unordered = TRUE; break;
+        case 'b': s_backgroundVerify = TRUE; break;
+        case 'l': s_offerList = TRUE; break;
+        default:
+            fprintf(stderr, "usage: %s [-n iterations] [-s image bytes] [-w content window]\n"
+                            "       [-e erase ns per sector] [-p program ns per write] [-z] [-x]\n"
+                            "       [-u] [-b] [-l]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if ((imageSize < (3 * BENCH_BLOCK_SIZE)) || (imageSize > RAM_BSP_BANK_SIZE) ||
+        (contentWindow > CFU_CONTENT_WINDOW_MAX) || (iterations == 0))
+    {
+        fprintf(stderr, "cfubench: image must be %u to %u bytes, window at most %u\n",
+                3 * BENCH_BLOCK_SIZE, RAM_BSP_BANK_SIZE, CFU_CONTENT_WINDOW_MAX);
+        return 2;
+    }
+
+    if (compressed && !CFU_COMPRESSED_PAYLOAD)
+    {
+        fprintf(stderr, "cfubench: -z needs CONFIG=-DCFU_COMPRESSED_PAYLOAD=1\n");
+        return 2;
+    }
+
+    if (unordered && (compressed || !CFU_UNORDERED_CONTENT))
+    {
+        fprintf(stderr, "cfubench: -u needs CONFIG=-DCFU_UNORDERED_CONTENT=1 and no -z\n");
+        return 2;
+    }
+
+    if (unordered && CFU_WRITE_COALESCING)
+    {
+        printf("note: -u is declined for a component that coalesces writes, "
+               "blocks are sent in order\n");
+    }
+
+    if ((contentWindow != 0) && CFU_WRITE_COALESCING)
+    {
+        printf("note: -w is declined for a component that coalesces writes, "
+               "blocks are sent stop-and-wait\n");
+    }
+
+    if (s_backgroundVerify && !CFU_BACKGROUND_VERIFY)
+    {
+        fprintf(stderr, "cfubench: -b needs CONFIG=-DCFU_BACKGROUND_VERIFY=1\n");
+        return 2;
+    }
+
+    if (s_offerList && !CFU_OFFER_LIST)
+    {
+        fprintf(stderr, "cfubench: -l needs CONFIG=-DCFU_OFFER_LIST=1\n");
+        return 2;
+    }
+
+    _BuildImage(imageSize);
+
+    if (compressed)
+    {
+        _CompressImage(imageSize);
+    }
+    else
+    {
+        memcpy(s_stream, s_image, imageSize);
+        s_streamSize = imageSize;
+    }
+
+    config.crcOffset = s_crcOffset;
+    config.pDigest = s_digest;
+    RamBspInit(&config);
+
+#if !CFU_STATIC_COMPONENTS
+    IComponentFirmwareUpdateRegisterComponent(&s_component);
+#endif
+    FirmwareUpdateInit();
+
+    for (i = 0; i < iterations; i++)
+    {
+        _RunUpdate((UINT8)contentWindow, compressed, unordered);
+    }
+
+    RamBspGetStats(&stats);
+
+#if CFU_CONTENT_WINDOW_MAX
+    // Encoded and out of order content is not windowed
+    if ((contentWindow != 0) && !compressed && !unordered)
+    {
+        windowSends = _RunWindowCheck((UINT8)contentWindow, &windowDropped);
+    }
+
+#endif
+#if CFU_RESUMABLE_TRANSFER
+    // Encoded and out of order content is never resumed
+    if (!compressed && !unordered)
+    {
+        resumeBlock = _RunResumeCheck(&interrupted);
+    }
+
+#endif
+#if CFU_OFFER_LIST
+    decisions = _RunOfferListCheck();
+
+#endif
+    if (memcmp(RamBspGetBank(), s_image, imageSize) != 0)
+    {
+        fprintf(stderr, "cfubench: staged image does not match\n");
+        return 1;
+    }
+#if CFU_RANGE_COMPARE
+
+    // Needs two whole ranges of the staged image
+    if (imageSize >= (2UL << BENCH_COMPARE_SHIFT))
+    {
+        compared = _RunCompareCheck();
+    }
+#endif
+
+    // Starts updates without finishing them, so it runs after the image
+    // is checked
+    freed = _RunAbandonCheck();
+#if CFU_REGION_CHECK
+    rejected = _RunRegionCheck();
+#endif
+
+    printf("image %u bytes sent as %u bytes in %u byte blocks, window %u, %u iterations\n",
+           (unsigned int)imageSize, (unsigned int)s_streamSize, BENCH_BLOCK_SIZE,
+           (unsigned int)contentWindow, (unsigned int)iterations);
+    printf("per update: %u sectors erased, %u write calls, %u flushes, image %s\n",
+           (unsigned int)(stats.sectorsErased / iterations),
+           (unsigned int)(stats.writeCalls / iterations),
+           (unsigned int)(stats.flushes / iterations),
+           stats.digestsAuthenticated ? "authenticated from its digest" : "hashed from flash");
+#if CFU_SHA256_BSP
+    printf("per update: %u SHA-256 blocks through ICompFwUpdateBspSha256Blocks\n",
+           (unsigned int)(stats.sha256Blocks / iterations));
+#endif
+#if CFU_CONTENT_WINDOW_MAX
+    if (windowSends != 0)
+    {
+        printf("window check: %u blocks sent for %u, %u lost, acknowledgements match\n",
+               (unsigned int)windowSends,
+               (unsigned int)((s_streamSize + BENCH_BLOCK_SIZE - 1) / BENCH_BLOCK_SIZE),
+               (unsigned int)windowDropped);
+    }
+#endif
+#if CFU_OFFER_LIST
+    printf("offer list check: %u decisions in order\n", (unsigned int)decisions);
+#endif
+    printf("abandon check: %u abandoned updates freed\n", (unsigned int)freed);
+#if CFU_REGION_CHECK
+    printf("region check: %u blocks at region edges rejected\n", (unsigned int)rejected);
+#endif
+#if CFU_RANGE_COMPARE
+    if (compared != 0)
+    {
+        printf("compare check: %u ranges compared, the stale one reported\n", (unsigned int)compared);
+    }
+#endif
+#if CFU_RESUMABLE_TRANSFER
+    if (interrupted != 0)
+    {
+        printf("resume check: reset after %u blocks, resumed from block %u\n",
+               (unsigned int)interrupted, (unsigned int)resumeBlock);
+    }
+#endif
+    _Report("offer", &s_offerTiming);
+    _Report("first block", &s_firstTiming);
+    _Report("middle block", &s_middleTiming);
+    _Report("last block", &s_lastTiming);
+
+    if (s_backgroundVerify)
+    {
+        _Report("background", &s_verifyTiming);
+    }
+#if CFU_TIMING_STATS
+    _ReportPhases();
+#endif
+#if !CFU_STATIC_COMPONENTS
+    // Registers more components, so it runs after everything else
+    _RunDispatchCheck();
+#endif
+
+    return 0;
+}
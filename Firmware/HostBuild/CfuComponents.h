@@ -0,0 +1,99 @@
+/*++
+    This file is part of Component Firmware Update (CFU), licensed under
+    the MIT License (MIT).
+
+    Copyright (c) Microsoft Corporation. All rights reserved.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+Module Name:
+
+    CfuComponents.h
+
+Abstract:
+
+    Component table of the benchmark, compiled into the firmware core when
+    it is built with CFU_STATIC_COMPONENTS.
+
+Environment:
+
+    Host build (Linux).
+--*/
+#pragma once
+
+//****************************************************************************
+//
+//                               INCLUDES
+//
+//****************************************************************************
+#include "coretypes.h"
+#include "ComponentFwUpdate.h"
+#include "ComponentFwUpdateConfig.h"
+#include "IComponentFirmwareUpdate.h"
+#include "RamBsp.h"
+
+//****************************************************************************
+//
+//                                  DEFINES
+//
+//****************************************************************************
+#if CFU_WRITE_LIST
+#define BENCH_ASYNC_FLAGS       (COMPONENT_FLAG_ASYNC_WRITE | COMPONENT_FLAG_WRITE_LIST)
+#elif CFU_ASYNC_WRITE
+#define BENCH_ASYNC_FLAGS       (COMPONENT_FLAG_ASYNC_WRITE)
+#else
+#define BENCH_ASYNC_FLAGS       (0)
+#endif
+#if CFU_COMPRESSED_PAYLOAD
+#define BENCH_COMPRESSED_FLAGS  (COMPONENT_FLAG_COMPRESSED_PAYLOAD)
+#else
+#define BENCH_COMPRESSED_FLAGS  (0)
+#endif
+#if CFU_STREAMING_DIGEST
+#define BENCH_DIGEST_FLAGS      (COMPONENT_FLAG_STREAMING_DIGEST)
+#else
+#define BENCH_DIGEST_FLAGS      (0)
+#endif
+#define BENCH_COMPONENT_FLAGS   (COMPONENT_FLAG_STREAMING_CRC | BENCH_ASYNC_FLAGS | \
+                                 BENCH_COMPRESSED_FLAGS | BENCH_DIGEST_FLAGS)
+#define BENCH_REGION_COUNT      (3)
+
+// The one component of the benchmark, handled by the BenchXxx functions
+#define CFU_COMPONENT_TABLE(X) \
+    X(BSP_YOURCOMPONENT, Bench, BENCH_COMPONENT_FLAGS, RAM_BSP_PAGE_SIZE, RAM_BSP_SECTOR_SIZE, \
+      0, 0, g_benchRegions, BENCH_REGION_COUNT, &g_ramBspStorage)
+
+//****************************************************************************
+//
+//                          GLOBAL VARIABLE EXTERNS
+//
+//****************************************************************************
+// Image layout checked by CFU_REGION_CHECK: code, CRC, then nothing
+extern COMPONENT_REGION g_benchRegions[BENCH_REGION_COUNT];
+
+//****************************************************************************
+//
+//                          GLOBAL FUNCTION EXTERNS
+//
+//****************************************************************************
+MCU_STATUS BenchGetVersion(UINT32* pVersion);
+MCU_STATUS BenchGetProductInfo(UINT32* pProductInfo);
+MCU_STATUS BenchProcessOffer(FWUPDATE_OFFER_COMMAND* pCommand, FWUPDATE_OFFER_RESPONSE* pResponse);
+MCU_STATUS BenchGetCrcOffset(UINT32* pOffset);
+MCU_STATUS BenchNotifySuccess(BOOL forceReset, READ_FIRMWARE_FUNC readHandler, READ_COMPLETED_FUNC readCompleteHandler);
@@ -0,0 +1,63 @@
+/*++
+    This file is part of Component Firmware Update (CFU), licensed under
+    the MIT License (MIT).
+
+    Copyright (c) Microsoft Corporation. All rights reserved.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+Module Name:
+
+    HostPlatform.h
+
+Abstract:
+
+    Platform definitions for building the firmware core on a development
+    machine. Included ahead of every source file by the HostBuild Makefile.
+
+Environment:
+
+    Host build (Linux).
+--*/
+#pragma once
+
+//****************************************************************************
+//
+//                               INCLUDES
+//
+//****************************************************************************
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+
+//****************************************************************************
+//
+//                                  DEFINES
+//
+//****************************************************************************
+#define ASSERT(x)                               assert(x)
+
+// The fake timer of RamBsp.c replaces the placeholder in ComponentFwUpdate.c
+#define CFU_BSP_TIMER                           (1)
+
+// Component table of the benchmark, for builds with CFU_STATIC_COMPONENTS
+#define CFU_COMPONENT_TABLE_HEADER              "CfuComponents.h"
+
+// ICompFwUpdateBspGetTicks of RamBsp.c counts nanoseconds
+#define CFU_TIMING_TICK_HZ                      (1000000000)
@@ -0,0 +1,527 @@
+/*++
+    This file is part of Component Firmware Update (CFU), licensed under
+    the MIT License (MIT).
+
+    Copyright (c) Microsoft Corporation. All rights reserved.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+Module Name:
+
+    RamBsp.c
+
+Abstract:
+
+    RAM backed implementation of ICompFwUpdateBsp.h and of the fail safe
+    timer, for running the firmware core on a development machine.
+
+Environment:
+
+    Host build (Linux).
+--*/
+//****************************************************************************
+//
+//                               INCLUDES
+//
+//****************************************************************************
+#include <time.h>
+#include "coretypes.h"
+#include "ComponentFwUpdateConfig.h"
+#include "Crc16.h"
+#include "ICompFwUpdateBsp.h"
+#include "RamBsp.h"
+#include "Sha256.h"
+
+//****************************************************************************
+//
+//                                  TYPEDEFS
+//
+//****************************************************************************
+typedef struct
+{
+    void    (*pCallback)(void);
+    UINT32  timeoutMs;
+    UINT32  elapsedMs;
+    BOOL    running;
+} RAM_BSP_TIMER;
+
+//****************************************************************************
+//
+//                              STATIC VARIABLES
+//
+//****************************************************************************
+static UINT8            s_bank[RAM_BSP_BANK_SIZE];
+static UINT8            s_currentBank[RAM_BSP_BANK_SIZE];
+// Pages programmed through the page write functions since they were erased
+static UINT8            s_programmedPages[RAM_BSP_BANK_SIZE / RAM_BSP_PAGE_SIZE / 8];
+static UINT32           s_imageLength;
+static RAM_BSP_CONFIG   s_config;
+static RAM_BSP_STATS    s_stats;
+static CFU_CHECKPOINT   s_checkpoints[MAX_UINT8 + 1];
+// Deferred offer responses not yet collected, oldest first
+static UINT8            s_offerResponses[RAM_BSP_MAX_QUEUED_RESPONSES][RAM_BSP_MAX_OFFER_RESPONSE];
+static UINT8            s_offerResponseCount;
+
+// TIMER_ID n is s_timers[n - 1]
+static RAM_BSP_TIMER    s_timers[RAM_BSP_MAX_TIMERS];
+static UINT8            s_timerCount;
+
+//****************************************************************************
+//
+//                              FUNCTION CODE
+//
+//****************************************************************************
+
+//****************************************************************************
+//
+// _Delay - Busy wait to model the time a flash operation takes.
+//
+// Input Parameters
+//      UINT32 ns - Time to wait.
+//
+//****************************************************************************
+static void _Delay(UINT32 ns)
+{
+    struct timespec start;
+    struct timespec now;
+
+    if (ns == 0)
+    {
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    do
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    } while ((UINT64)((now.tv_sec - start.tv_sec) * 1000000000LL +
+                      (now.tv_nsec - start.tv_nsec)) < ns);
+}
+
+//****************************************************************************
+//
+// _Program - Program data into the bank. Like flash, programming can only
+//            clear bits, so writing a location that was not erased leaves
+//            the AND of the old and new data.
+//
+// Input Parameters
+//      UINT32 offset - Where to write.
+//      UINT8* pData - Data to write.
+//      UINT32 length - Number of bytes.
+//
+// Return
+//      0 on success.
+//
+//****************************************************************************
+static UINT32 _Program(UINT32 offset, UINT8* pData, UINT32 length)
+{
+    UINT32 i;
+
+    if ((offset > RAM_BSP_BANK_SIZE) || (length > (RAM_BSP_BANK_SIZE - offset)))
+    {
+        return 1;
+    }
+
+    for (i = 0; i < length; i++)
+    {
+        s_bank[offset + i] &= pData[i];
+    }
+
+    if ((offset + length) > s_imageLength)
+    {
+        s_imageLength = offset + length;
+    }
+
+    s_stats.writeCalls++;
+    s_stats.bytesWritten += length;
+    _Delay(s_config.programLatencyNs);
+
+    return 0;
+}
+
+//****************************************************************************
+//
+// _ProgramPage - Program a page, or part of one, into the bank. Like flash
+//                with ECC, a page can only be programmed once between
+//                erases, so a second write to it fails even where it would
+//                only clear bits.
+//
+// Input Parameters
+//      UINT32 offset - Where to write.
+//      UINT8* pData - Data to write.
+//      UINT32 length - Number of bytes, within one page.
+//
+// Return
+//      0 on success.
+//
+//****************************************************************************
+static UINT32 _ProgramPage(UINT32 offset, UINT8* pData, UINT32 length)
+{
+    UINT32 page = offset / RAM_BSP_PAGE_SIZE;
+    UINT8 bit = (UINT8)(1u << (page & 7));
+
+    if ((length == 0) || (offset >= RAM_BSP_BANK_SIZE) ||
+        (((offset + length - 1) / RAM_BSP_PAGE_SIZE) != page) ||
+        (s_programmedPages[page >> 3] & bit))
+    {
+        return 1;
+    }
+
+    s_programmedPages[page >> 3] |= bit;
+    return _Program(offset, pData, length);
+}
+
+//****************************************************************************
+//
+// _Erase - Erase whole sectors of the bank.
+//
+// Input Parameters
+//      UINT32 offset - Start of the first sector.
+//      UINT32 sectors - Number of sectors.
+//
+//****************************************************************************
+static void _Erase(UINT32 offset, UINT32 sectors)
+{
+    UINT32 page;
+
+    memset(&s_bank[offset], 0xFF, sectors * RAM_BSP_SECTOR_SIZE);
+
+    for (page = offset / RAM_BSP_PAGE_SIZE;
+         page < (offset + sectors * RAM_BSP_SECTOR_SIZE) / RAM_BSP_PAGE_SIZE; page++)
+    {
+        s_programmedPages[page >> 3] &= (UINT8)~(1u << (page & 7));
+    }
+
+    s_stats.sectorsErased += sectors;
+
+    while (sectors--)
+    {
+        _Delay(s_config.eraseLatencyNs);
+    }
+}
+
+//****************************************************************************
+//
+//                              GLOBAL FUNCTIONS
+//
+//****************************************************************************
+void RamBspInit(const RAM_BSP_CONFIG* pConfig)
+{
+    s_config = *pConfig;
+    memset(s_bank, 0xFF, sizeof(s_bank));
+    memset(s_currentBank, 0xFF, sizeof(s_currentBank));
+    memset(s_programmedPages, 0, sizeof(s_programmedPages));
+    memset(s_checkpoints, 0, sizeof(s_checkpoints));
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_imageLength = 0;
+    s_offerResponseCount = 0;
+}
+
+const UINT8* RamBspGetBank(void)
+{
+    return s_bank;
+}
+
+UINT32 RamBspGetImageLength(void)
+{
+    return s_imageLength;
+}
+
+void RamBspGetStats(RAM_BSP_STATS* pStats)
+{
+    *pStats = s_stats;
+}
+
+void RamBspSetCurrentImage(const UINT8* pImage, UINT32 length)
+{
+    ASSERT(length <= RAM_BSP_BANK_SIZE);
+
+    memset(s_currentBank, 0xFF, sizeof(s_currentBank));
+    memcpy(s_currentBank, pImage, length);
+}
+
+void RamBspAdvanceTime(UINT32 ms)
+{
+    // A millisecond at a time, so periodic timers that re-arm themselves
+    // from their callback fire as often as they would on a target.
+    while (ms--)
+    {
+        UINT8 i;
+
+        for (i = 0; i < s_timerCount; i++)
+        {
+            RAM_BSP_TIMER* pTimer = &s_timers[i];
+
+            if (pTimer->running && (++pTimer->elapsedMs >= pTimer->timeoutMs))
+            {
+                pTimer->running = FALSE;
+                pTimer->pCallback();
+            }
+        }
+    }
+}
+
+BOOL RamBspGetOfferResponse(UINT8* pResponse)
+{
+    if (s_offerResponseCount == 0)
+    {
+        return FALSE;
+    }
+
+    memcpy(pResponse, s_offerResponses[0], RAM_BSP_MAX_OFFER_RESPONSE);
+    memmove(s_offerResponses[0], s_offerResponses[1],
+            --s_offerResponseCount * sizeof(s_offerResponses[0]));
+    return TRUE;
+}
+
+TIMER_ID BSP_Timer_Create(void (* pTimerCallback)(void), UINT32 timeoutMs)
+{
+    RAM_BSP_TIMER* pTimer;
+
+    ASSERT(s_timerCount < RAM_BSP_MAX_TIMERS);
+
+    pTimer = &s_timers[s_timerCount++];
+    pTimer->pCallback = pTimerCallback;
+    pTimer->timeoutMs = timeoutMs;
+    pTimer->running = FALSE;
+
+    return (TIMER_ID) s_timerCount;
+}
+
+void BSP_Timer_Stop(TIMER_ID timerId)
+{
+    s_timers[timerId - 1].running = FALSE;
+}
+
+void BSP_Timer_Restart(TIMER_ID timerId)
+{
+    s_timers[timerId - 1].elapsedMs = 0;
+    s_timers[timerId - 1].running = TRUE;
+}
+
+// Nanoseconds of the monotonic clock, see CFU_TIMING_TICK_HZ in HostPlatform.h
+UINT32 ICompFwUpdateBspGetTicks(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (UINT32)((UINT64)now.tv_sec * 1000000000ULL + (UINT64)now.tv_nsec);
+}
+
+UINT32 ICompFwUpdateBspPrepare(UINT8 componentId)
+{
+    s_imageLength = 0;
+
+#if !CFU_LAZY_ERASE
+    // With lazy erase the core erases each sector before it is written
+    _Erase(0, RAM_BSP_BANK_SIZE / RAM_BSP_SECTOR_SIZE);
+#endif
+
+    return 0;
+}
+
+UINT32 ICompFwUpdateBspEraseSector(UINT32 offset, UINT8 componentId)
+{
+    if ((offset % RAM_BSP_SECTOR_SIZE) || (offset >= RAM_BSP_BANK_SIZE))
+    {
+        return 1;
+    }
+
+    _Erase(offset, 1);
+    return 0;
+}
+
+UINT32 ICompFwUpdateBspWrite(UINT32 offset, UINT8* pData, UINT8 length, UINT8 componentId)
+{
+    return _Program(offset, pData, length);
+}
+
+UINT32 ICompFwUpdateBspWritePage(UINT32 offset, UINT8* pData, UINT16 length, UINT8 componentId)
+{
+    return _ProgramPage(offset, pData, length);
+}
+
+UINT32 ICompFwUpdateBspWritePageAsync(UINT32 offset, UINT8* pData, UINT16 length, UINT8 componentId,
+                                      WRITE_COMPLETED_FUNC writeCompleteHandler)
+{
+    // The page is programmed before returning, so the completion is
+    // reported straight away.
+    writeCompleteHandler(componentId, _ProgramPage(offset, pData, length));
+    return 0;
+}
+
+UINT32 ICompFwUpdateBspWriteList(const CFU_WRITE_DESCRIPTOR* pList, UINT8 count, UINT8 componentId,
+                                 WRITE_COMPLETED_FUNC writeCompleteHandler)
+{
+    UINT32 result = 0;
+    UINT8 i;
+
+    // Programmed one page after the other, then reported as one completion
+    // as a DMA chain would be.
+    for (i = 0; (i < count) && (result == 0); i++)
+    {
+        result = _ProgramPage(pList[i].offset, pList[i].pData, pList[i].length);
+    }
+
+    writeCompleteHandler(componentId, result);
+    return 0;
+}
+
+void ICompFwUpdateBspWaitWrite(UINT8 componentId)
+{
+    // Writes complete before they return, so there is never anything to
+    // wait for.
+}
+
+UINT32 ICompFwUpdateBspRead(UINT32 offset, UINT8* pData, UINT16 length, UINT8 componentId)
+{
+    if ((offset > RAM_BSP_BANK_SIZE) || (length > (RAM_BSP_BANK_SIZE - offset)))
+    {
+        return 1;
+    }
+
+    memcpy(pData, &s_bank[offset], length);
+    return 0;
+}
+
+// Nothing is cached, the call is only counted
+static UINT32 _Flush(UINT8 componentId)
+{
+    s_stats.flushes++;
+    return 0;
+}
+
+// The bank holds one image at a time, whichever component it belongs to
+static INT32 _Authenticate(UINT8 componentId)
+{
+    return ICompFwUpdateBspAuthenticateFWImage();
+}
+
+UINT32 ICompFwUpdateBspReadCurrent(UINT32 offset, UINT8* pData, UINT16 length, UINT8 componentId)
+{
+    if ((offset > RAM_BSP_BANK_SIZE) || (length > (RAM_BSP_BANK_SIZE - offset)))
+    {
+        return 1;
+    }
+
+    memcpy(pData, &s_currentBank[offset], length);
+    return 0;
+}
+
+UINT32 ICompFwUpdateBspCalcCRC(UINT16 *pCRC, UINT8 componentId)
+{
+    UINT32 crcOffset = s_config.crcOffset;
+    UINT16 crc = CRC16_INITIAL_VALUE;
+
+    if ((crcOffset + sizeof(UINT16)) > s_imageLength)
+    {
+        return 1;
+    }
+
+    crc = Crc16Update(crc, s_bank, crcOffset);
+    crc = Crc16Update(crc, &s_bank[crcOffset + sizeof(UINT16)],
+                      s_imageLength - crcOffset - sizeof(UINT16));
+
+    *pCRC = crc;
+    return 0;
+}
+
+const COMPONENT_STORAGE g_ramBspStorage =
+{
+    ICompFwUpdateBspPrepare,
+    ICompFwUpdateBspEraseSector,
+    ICompFwUpdateBspWrite,
+    ICompFwUpdateBspWritePage,
+    ICompFwUpdateBspWritePageAsync,
+    ICompFwUpdateBspWriteList,
+    ICompFwUpdateBspRead,
+    ICompFwUpdateBspReadCurrent,
+    ICompFwUpdateBspCalcCRC,
+    _Flush,
+    _Authenticate,
+};
+
+UINT32 ICompFwUpdateBspReadCheckpoint(CFU_CHECKPOINT* pCheckpoint, UINT8 componentId)
+{
+    *pCheckpoint = s_checkpoints[componentId];
+    return 0;
+}
+
+UINT32 ICompFwUpdateBspWriteCheckpoint(CFU_CHECKPOINT* pCheckpoint, UINT8 componentId)
+{
+    s_checkpoints[componentId] = *pCheckpoint;
+    return 0;
+}
+
+INT32 ICompFwUpdateBspAuthenticateFWImage(void)
+{
+    SHA256_CONTEXT context;
+    UINT8 digest[SHA256_DIGEST_SIZE];
+
+    // Without a streaming digest the staged image has to be read back
+    Sha256Init(&context);
+    Sha256Update(&context, s_bank, s_imageLength);
+    Sha256Final(&context, digest);
+    s_stats.imagesHashed++;
+
+    if (s_config.pDigest && (memcmp(digest, s_config.pDigest, sizeof(digest)) != 0))
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+// The host has no hash accelerator, the portable code stands in for one
+void ICompFwUpdateBspSha256Blocks(UINT32* pState, const UINT8* pData, UINT32 blockCount)
+{
+    s_stats.sha256Blocks += blockCount;
+    Sha256Blocks(pState, pData, blockCount);
+}
+
+INT32 ICompFwUpdateBspAuthenticateDigest(const UINT8* pDigest, UINT8 componentId)
+{
+    s_stats.digestsAuthenticated++;
+
+    if (s_config.pDigest && (memcmp(pDigest, s_config.pDigest, SHA256_DIGEST_SIZE) != 0))
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+void ICompFwUpdateBspSignalUpdateComplete(void)
+{
+}
+
+void ICompFwUpdateBspSignalVerifyPending(void)
+{
+    // The benchmark calls FirmwareUpdateBackgroundTask itself
+}
+
+void ICompFwUpdateBspSendOfferResponse(const UINT8* pResponse, UINT8 length)
+{
+    ASSERT(length <= RAM_BSP_MAX_OFFER_RESPONSE);
+    ASSERT(s_offerResponseCount < RAM_BSP_MAX_QUEUED_RESPONSES);
+
+    memset(s_offerResponses[s_offerResponseCount], 0, RAM_BSP_MAX_OFFER_RESPONSE);
+    memcpy(s_offerResponses[s_offerResponseCount++], pResponse, length);
+}
@@ -0,0 +1,123 @@
+/*++
+    This file is part of Component Firmware Update (CFU), licensed under
+    the MIT License (MIT).
+
+    Copyright (c) Microsoft Corporation. All rights reserved.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+Module Name:
+
+    RamBsp.h
+
+Abstract:
+
+    RAM backed implementation of ICompFwUpdateBsp.h and of the fail safe
+    timer, for running the firmware core on a development machine.
+
+Environment:
+
+    Host build (Linux).
+--*/
+#pragma once
+
+//****************************************************************************
+//
+//                               INCLUDES
+//
+//****************************************************************************
+#include "coretypes.h"
+#include "IComponentFirmwareUpdate.h"
+
+//****************************************************************************
+//
+//                                  DEFINES
+//
+//****************************************************************************
+// One staging bank shared by all components
+#define RAM_BSP_BANK_SIZE                       (1024 * 1024)
+#define RAM_BSP_PAGE_SIZE                       (256)
+#define RAM_BSP_SECTOR_SIZE                     (4096)
+#define RAM_BSP_MAX_TIMERS                      (4)
+#define RAM_BSP_MAX_OFFER_RESPONSE              (16)
+#define RAM_BSP_MAX_QUEUED_RESPONSES            (16)
+
+//****************************************************************************
+//
+//                                  TYPEDEFS
+//
+//****************************************************************************
+typedef struct
+{
+    // Time spent in each erased sector and in each write call, to model the
+    // flash of a target. Both busy wait.
+    UINT32 eraseLatencyNs;
+    UINT32 programLatencyNs;
+    // Location of the embedded CRC, skipped by ICompFwUpdateBspCalcCRC
+    UINT32 crcOffset;
+    // SHA-256 the image must have to be authenticated, NULL to accept any.
+    // ICompFwUpdateBspAuthenticateFWImage hashes the staged image for it.
+    const UINT8* pDigest;
+} RAM_BSP_CONFIG;
+
+typedef struct
+{
+    UINT32 sectorsErased;
+    UINT32 writeCalls;
+    UINT32 bytesWritten;
+    UINT32 imagesHashed;
+    UINT32 digestsAuthenticated;
+    UINT32 flushes;
+    UINT32 sha256Blocks;            // Blocks hashed by ICompFwUpdateBspSha256Blocks
+} RAM_BSP_STATS;
+
+//****************************************************************************
+//
+//                          GLOBAL VARIABLE EXTERNS
+//
+//****************************************************************************
+// The ICompFwUpdateBspXxx functions of this file plus a Flush that only
+// counts, for registering as a component's storage.
+extern const COMPONENT_STORAGE g_ramBspStorage;
+
+//****************************************************************************
+//
+//                          GLOBAL FUNCTION EXTERNS
+//
+//****************************************************************************
+// Erase the bank, forget all checkpoints and statistics and apply pConfig.
+void RamBspInit(const RAM_BSP_CONFIG* pConfig);
+
+// The staging bank and the number of bytes up to the highest byte written
+// since the last ICompFwUpdateBspPrepare.
+const UINT8* RamBspGetBank(void);
+UINT32 RamBspGetImageLength(void);
+
+void RamBspGetStats(RAM_BSP_STATS* pStats);
+
+// Set the image the component is running, read by ICompFwUpdateBspReadCurrent.
+void RamBspSetCurrentImage(const UINT8* pImage, UINT32 length);
+
+// Move the fake clock forward, firing the timers that expire on the way.
+void RamBspAdvanceTime(UINT32 ms);
+
+// Copy out the oldest deferred offer response sent with
+// ICompFwUpdateBspSendOfferResponse and not yet collected. FALSE if there is
+// none.
+BOOL RamBspGetOfferResponse(UINT8* pResponse);
@@ -1,90 +1,214 @@
-/*++
-    This file is part of Component Firmware Update (CFU), licensed under
-    the MIT License (MIT).
-
-    Copyright (c) Microsoft Corporation. All rights reserved.
-
-    Permission is hereby granted, free of charge, to any person obtaining a copy
-    of this software and associated documentation files (the "Software"), to deal
-    in the Software without restriction, including without limitation the rights
-    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-    copies of the Software, and to permit persons to whom the Software is
-    furnished to do so, subject to the following conditions:
-
-    The above copyright notice and this permission notice shall be included in all
-    copies or substantial portions of the Software.
-
-    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-    SOFTWARE.
-
-Module Name:
-
-    ICompFwUpdateBsp.h
-
-Abstract:
-
-    Interface definition for platform bsp fwu support.
-
-Environment:
-
-    Firmware driver. 
---*/
-#pragma once
-
-//****************************************************************************
-//
-//                               INCLUDES
-//
-//****************************************************************************
-#include "coretypes.h"
-//****************************************************************************
-//
-//                                  DEFINES
-//
-//****************************************************************************
-
-//****************************************************************************
-//
-//                                  TYPEDEFS
-//
-//****************************************************************************
-
-//****************************************************************************
-//
-//                          GLOBAL VARIABLE EXTERNS
-//
-//****************************************************************************
-
-//****************************************************************************
-//
-//                          GLOBAL FUNCTION EXTERNS
-//
-//****************************************************************************
-
-// Readers and writers for firmware update intermediates/self update handlers
-// Developer TODO - implement function to prepare memory to receive image.
-//                  (NOTE: if image stored to flash/NVM, this is typically where
-//                   the flash area is erased)
-UINT32 ICompFwUpdateBspPrepare(UINT8 componentId);
-
-// Developer TODO - implement function to write data chunk memory/flash.
-UINT32 ICompFwUpdateBspWrite(UINT32 offset, UINT8* pData, UINT8 length, UINT8 componentId);
-
-// Developer TODO - implement function to read data chunk from memory/flash.
-UINT32 ICompFwUpdateBspRead(UINT32 offset, UINT8* pData, UINT16 length, UINT8 componentId);
-
-// Developer TODO - implement function to calculate the CRC for the specific component image
-UINT32 ICompFwUpdateBspCalcCRC(UINT16 *pCRC, UINT8 componentId);
-
-// Developer TODO - implement function to perform authentication check for the specific component image
-INT32 ICompFwUpdateBspAuthenticateFWImage(void);
-
-// Developer TODO - implement function to perform any required functionality to let the 
-//                  system know a new image has been downloaded and verified. (ex: this
-//                  could be where the boot loader is modified to point to the new image )
-void ICompFwUpdateBspSignalUpdateComplete(void);
\ No newline at end of file
+/*++
+    This file is part of Component Firmware Update (CFU), licensed under
+    the MIT License (MIT).
+
+    Copyright (c) Microsoft Corporation. All rights reserved.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+Module Name:
+
+    ICompFwUpdateBsp.h
+
+Abstract:
+
+    Interface definition for platform bsp fwu support.
+
+Environment:
+
+    Firmware driver. 
+--*/
+#pragma once
+
+//****************************************************************************
+//
+//                               INCLUDES
+//
+//****************************************************************************
+#include "coretypes.h"
+//****************************************************************************
+//
+//                                  DEFINES
+//
+//****************************************************************************
+
+//****************************************************************************
+//
+//                                  TYPEDEFS
+//
+//****************************************************************************
+typedef UINT16 TIMER_ID; // change this to your needs for timer definition
+
+// Called by the BSP when an asynchronous page write has finished.
+// result is 0 on success.
+typedef void (*WRITE_COMPLETED_FUNC) (UINT8 componentId, UINT32 result);
+
+// One page of a list passed to ICompFwUpdateBspWriteList
+typedef struct
+{
+    UINT32  offset;
+    UINT8*  pData;
+    UINT16  length;
+} CFU_WRITE_DESCRIPTOR;
+
+// Resume point of an image being staged, kept in non volatile storage by the
+// BSP. Every block up to and including sequenceNumber has been programmed,
+// ending at address. A version of 0 means there is no resume point.
+typedef struct
+{
+    UINT32 version;
+    UINT32 address;
+    UINT16 sequenceNumber;
+    UINT8  componentId;
+    UINT8  reserved0;
+} CFU_CHECKPOINT;
+
+//****************************************************************************
+//
+//                          GLOBAL VARIABLE EXTERNS
+//
+//****************************************************************************
+
+//****************************************************************************
+//
+//                          GLOBAL FUNCTION EXTERNS
+//
+//****************************************************************************
+
+// Developer TODO - implement the fail safe timer. The callback must be called
+//                  once timeoutMs has passed since the timer was last
+//                  restarted, unless it was stopped. Only needed when
+//                  CFU_BSP_TIMER is enabled.
+TIMER_ID BSP_Timer_Create(void (* pTimerCallback)(void), UINT32 timeoutMs);
+void BSP_Timer_Stop(TIMER_ID timerId);
+void BSP_Timer_Restart(TIMER_ID timerId);
+
+// Developer TODO - implement function to read a free running counter, e.g.
+//                  a cycle counter, running at CFU_TIMING_TICK_HZ. Only
+//                  needed when CFU_TIMING_STATS is enabled.
+UINT32 ICompFwUpdateBspGetTicks(void);
+
+// Readers and writers for firmware update intermediates/self update handlers.
+// Prepare, EraseSector, Write, WritePage, WritePageAsync, WriteList, Read,
+// ReadCurrent and CalcCRC are only used for components registered without
+// their own pStorage.
+// Developer TODO - implement function to prepare memory to receive image.
+//                  (NOTE: if image stored to flash/NVM, this is typically where
+//                   the flash area is erased)
+UINT32 ICompFwUpdateBspPrepare(UINT8 componentId);
+
+// Developer TODO - implement function to erase the sector starting at offset.
+//                  Only needed when CFU_LAZY_ERASE is enabled.
+UINT32 ICompFwUpdateBspEraseSector(UINT32 offset, UINT8 componentId);
+
+// Developer TODO - implement function to write data chunk memory/flash.
+UINT32 ICompFwUpdateBspWrite(UINT32 offset, UINT8* pData, UINT8 length, UINT8 componentId);
+
+// Developer TODO - implement function to write a page of data to memory/flash.
+//                  Only needed when CFU_WRITE_COALESCING is enabled. offset is
+//                  page aligned except for the first page of an image, and
+//                  the data never crosses a page boundary.
+UINT32 ICompFwUpdateBspWritePage(UINT32 offset, UINT8* pData, UINT16 length, UINT8 componentId);
+
+// Developer TODO - implement function to start writing a page of data to
+//                  memory/flash and return without waiting for it to be
+//                  programmed. writeCompleteHandler must be called once the
+//                  page is programmed (it may be called from an ISR). pData
+//                  stays valid until then. Only needed when CFU_ASYNC_WRITE is
+//                  enabled; returns non zero if the write could not be started.
+UINT32 ICompFwUpdateBspWritePageAsync(UINT32 offset, UINT8* pData, UINT16 length, UINT8 componentId,
+                                      WRITE_COMPLETED_FUNC writeCompleteHandler);
+
+// Developer TODO - implement function to start writing a list of pages to
+//                  memory/flash, e.g. as one DMA descriptor chain, and return
+//                  without waiting. Each page has the same alignment as for
+//                  ICompFwUpdateBspWritePage; pages need not be contiguous.
+//                  writeCompleteHandler must be called once, when the whole
+//                  list is programmed (it may be called from an ISR). pList
+//                  and the page data stay valid until then. Only needed when
+//                  CFU_WRITE_LIST is enabled; returns non zero if the write
+//                  could not be started.
+UINT32 ICompFwUpdateBspWriteList(const CFU_WRITE_DESCRIPTOR* pList, UINT8 count, UINT8 componentId,
+                                 WRITE_COMPLETED_FUNC writeCompleteHandler);
+
+// Developer TODO - implement function to sleep or yield until the write
+//                  started with ICompFwUpdateBspWritePageAsync or
+//                  ICompFwUpdateBspWriteList may have completed, e.g. by
+//                  waiting for the flash interrupt. It may return early;
+//                  the core calls it again until writeCompleteHandler has
+//                  been called. Only needed when CFU_ASYNC_WRITE is enabled.
+void ICompFwUpdateBspWaitWrite(UINT8 componentId);
+
+// Developer TODO - implement functions to load and store the resume point of
+//                  a component's staging bank so that it survives a reset.
+//                  Only needed when CFU_RESUMABLE_TRANSFER is enabled. Return
+//                  non zero on failure; a component that never had a resume
+//                  point stored loads one with version 0.
+UINT32 ICompFwUpdateBspReadCheckpoint(CFU_CHECKPOINT* pCheckpoint, UINT8 componentId);
+UINT32 ICompFwUpdateBspWriteCheckpoint(CFU_CHECKPOINT* pCheckpoint, UINT8 componentId);
+
+// Developer TODO - implement function to read data chunk from memory/flash.
+UINT32 ICompFwUpdateBspRead(UINT32 offset, UINT8* pData, UINT16 length, UINT8 componentId);
+
+// Developer TODO - implement function to read data chunk from the image the
+//                  component is currently running, as opposed to the image
+//                  being staged. Only needed when CFU_DELTA_PAYLOAD is enabled.
+//                  Must return non zero for a range beyond the running
+//                  image; the core only checks it against the region table
+//                  of the component, or against the end of its CRC when it
+//                  has none.
+UINT32 ICompFwUpdateBspReadCurrent(UINT32 offset, UINT8* pData, UINT16 length, UINT8 componentId);
+
+// Developer TODO - implement function to calculate the CRC for the specific component image
+UINT32 ICompFwUpdateBspCalcCRC(UINT16 *pCRC, UINT8 componentId);
+
+// Developer TODO - implement function to perform authentication check for the specific component image
+INT32 ICompFwUpdateBspAuthenticateFWImage(void);
+
+// Developer TODO - implement function to authenticate a component image from
+//                  the SHA-256 digest (see Sha256.h) accumulated while it was
+//                  written, e.g. by verifying the signature of the digest.
+//                  Only needed when CFU_STREAMING_DIGEST is enabled. Images
+//                  that could not be digested in order are authenticated
+//                  with ICompFwUpdateBspAuthenticateFWImage instead.
+INT32 ICompFwUpdateBspAuthenticateDigest(const UINT8* pDigest, UINT8 componentId);
+
+// Developer TODO - implement function to run the SHA-256 compression
+//                  function over blockCount 64 byte blocks on a hash
+//                  accelerator, updating the eight word state in place. Only
+//                  needed when CFU_SHA256_BSP is enabled.
+void ICompFwUpdateBspSha256Blocks(UINT32* pState, const UINT8* pData, UINT32 blockCount);
+
+// Developer TODO - implement function to perform any required functionality to let the 
+//                  system know a new image has been downloaded and verified. (ex: this
+//                  could be where the boot loader is modified to point to the new image )
+void ICompFwUpdateBspSignalUpdateComplete(void);
+
+// Developer TODO - implement function to wake the task that calls
+//                  FirmwareUpdateBackgroundTask, e.g. by posting an event to
+//                  it. The task must not run at the same time as the
+//                  ProcessCFWUxxx functions. Only needed when
+//                  CFU_BACKGROUND_VERIFY is enabled.
+void ICompFwUpdateBspSignalVerifyPending(void);
+
+// Developer TODO - implement function to send an offer response that was
+//                  deferred (FIRMWARE_UPDATE_OFFER_DEFERRED) to the host,
+//                  e.g. as an input report. Only needed when
+//                  CFU_BACKGROUND_VERIFY or CFU_OFFER_LIST is enabled.
+void ICompFwUpdateBspSendOfferResponse(const UINT8* pResponse, UINT8 length);
\ No newline at end of file
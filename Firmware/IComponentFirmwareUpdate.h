@@ -1,95 +1,207 @@
-/*++
-    This file is part of Component Firmware Update (CFU), licensed under
-    the MIT License (MIT).
-
-    Copyright (c) Microsoft Corporation. All rights reserved.
-
-    Permission is hereby granted, free of charge, to any person obtaining a copy
-    of this software and associated documentation files (the "Software"), to deal
-    in the Software without restriction, including without limitation the rights
-    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-    copies of the Software, and to permit persons to whom the Software is
-    furnished to do so, subject to the following conditions:
-
-    The above copyright notice and this permission notice shall be included in all
-    copies or substantial portions of the Software.
-
-    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-    SOFTWARE.
-
-Module Name:
-
-    IComponentFimrwareUpdate.h
-
-Abstract:
-
-    Header for CFU Interface
-
-Environment:
-
-    Firmware driver. 
---*/
-
-#pragma once
-
-//****************************************************************************
-//
-//                               INCLUDES
-//
-//****************************************************************************
-#include "McuStatus.h"
-#include "ComponentFwUpdate.h"
-//****************************************************************************
-//
-//                                  DEFINES
-//
-//****************************************************************************
-
-//****************************************************************************
-//
-//                                  TYPEDEFS
-//
-//****************************************************************************
-
-typedef UINT32 (*READ_FIRMWARE_FUNC) (UINT32 offset, 
-                                      UINT8* pData, 
-                                      UINT16 length, 
-                                      UINT8 componentId);
-typedef void (*READ_COMPLETED_FUNC) (void);
-
-typedef struct
-{
-    MCU_STATUS (*GetVersion)                (UINT32* pVersion);
-    MCU_STATUS (*GetProductInfo)            (UINT32* pProductInfo);
-    MCU_STATUS (*ProcessOffer)              (FWUPDATE_OFFER_COMMAND* pCommand, 
-                                             FWUPDATE_OFFER_RESPONSE* pResponse);
-    MCU_STATUS (*GetCrcOffset)              (UINT32* pOffset);  
-    MCU_STATUS (*NotifySuccess)             (BOOL forceReset, 
-                                             READ_FIRMWARE_FUNC readHandler, 
-                                             READ_COMPLETED_FUNC readCompleteHandler);
-} ICOMPONENT_INTERFACE;
-
-typedef struct COMPONENT_REGISTRATION_STRUCT
-{
-    struct COMPONENT_REGISTRATION_STRUCT* pNext;
-    const ICOMPONENT_INTERFACE interface;
-    const UINT8 componentId;
-} COMPONENT_REGISTRATION;
-
-//****************************************************************************
-//
-//                          GLOBAL VARIABLE EXTERNS
-//
-//****************************************************************************
-
-//****************************************************************************
-//
-//                          GLOBAL FUNCTION EXTERNS
-//
-//****************************************************************************
-void IComponentFirmwareUpdateRegisterComponent(COMPONENT_REGISTRATION* pRegistration);
+/*++
+    This file is part of Component Firmware Update (CFU), licensed under
+    the MIT License (MIT).
+
+    Copyright (c) Microsoft Corporation. All rights reserved.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+Module Name:
+
+    IComponentFimrwareUpdate.h
+
+Abstract:
+
+    Header for CFU Interface
+
+Environment:
+
+    Firmware driver. 
+--*/
+
+#pragma once
+
+//****************************************************************************
+//
+//                               INCLUDES
+//
+//****************************************************************************
+#include "McuStatus.h"
+#include "ComponentFwUpdate.h"
+#include "ICompFwUpdateBsp.h"
+//****************************************************************************
+//
+//                                  DEFINES
+//
+//****************************************************************************
+// COMPONENT_REGISTRATION flags
+// The embedded image CRC is CRC-16/CCITT-FALSE (see Crc16.h) over every
+// downloaded byte in address order, skipping the two CRC bytes themselves.
+// The CFU engine accumulates it while blocks are written.
+#define COMPONENT_FLAG_STREAMING_CRC            (0x01)
+// Additionally verify the CRC with ICompFwUpdateBspCalcCRC over the whole
+// staged image. Only meaningful together with COMPONENT_FLAG_STREAMING_CRC.
+#define COMPONENT_FLAG_FULL_IMAGE_CRC           (0x02)
+// Program pages with ICompFwUpdateBspWritePageAsync so the next blocks are
+// acknowledged while the previous page is still being programmed. Requires
+// a non zero writePageSize and CFU_ASYNC_WRITE.
+#define COMPONENT_FLAG_ASYNC_WRITE              (0x04)
+// Accept offers with a delta payload, rebuilt against the running image read
+// through ReadCurrent of the component's storage. Requires CFU_DELTA_PAYLOAD and an
+// image that is staged apart from the running one.
+#define COMPONENT_FLAG_DELTA_PAYLOAD            (0x08)
+// Accept offers with a compressed payload. Requires CFU_COMPRESSED_PAYLOAD.
+#define COMPONENT_FLAG_COMPRESSED_PAYLOAD       (0x10)
+// Accumulate a SHA-256 digest of the image while it is written and
+// authenticate it with ICompFwUpdateBspAuthenticateDigest. Requires
+// CFU_STREAMING_DIGEST.
+#define COMPONENT_FLAG_STREAMING_DIGEST         (0x20)
+// Together with COMPONENT_FLAG_ASYNC_WRITE, program pages in lists with
+// ICompFwUpdateBspWriteList instead of one at a time. Requires
+// CFU_WRITE_LIST.
+#define COMPONENT_FLAG_WRITE_LIST               (0x40)
+
+// COMPONENT_REGION types. Content may be written anywhere but in reserved
+// regions; the CRC and signature types describe the image layout for the
+// component's own use (e.g. in GetCrcOffset).
+#define COMPONENT_REGION_WRITABLE               (0x00)
+#define COMPONENT_REGION_CRC                    (0x01)
+#define COMPONENT_REGION_SIGNATURE              (0x02)
+#define COMPONENT_REGION_RESERVED               (0x03)
+
+//****************************************************************************
+//
+//                                  TYPEDEFS
+//
+//****************************************************************************
+
+typedef UINT32 (*READ_FIRMWARE_FUNC) (UINT32 offset, 
+                                      UINT8* pData, 
+                                      UINT16 length, 
+                                      UINT8 componentId);
+typedef void (*READ_COMPLETED_FUNC) (void);
+
+typedef struct
+{
+    MCU_STATUS (*GetVersion)                (UINT32* pVersion);
+    MCU_STATUS (*GetProductInfo)            (UINT32* pProductInfo);
+    MCU_STATUS (*ProcessOffer)              (FWUPDATE_OFFER_COMMAND* pCommand, 
+                                             FWUPDATE_OFFER_RESPONSE* pResponse);
+    MCU_STATUS (*GetCrcOffset)              (UINT32* pOffset);  
+    MCU_STATUS (*NotifySuccess)             (BOOL forceReset, 
+                                             READ_FIRMWARE_FUNC readHandler, 
+                                             READ_COMPLETED_FUNC readCompleteHandler);
+} ICOMPONENT_INTERFACE;
+
+// Storage of a component's staging area, see COMPONENT_REGISTRATION. Each
+// function has the contract of the ICompFwUpdateBspXxx function of the same
+// name and is only needed when that one is. Flush is optional: when not NULL
+// it is called once all data written so far has been handed over, before
+// the image is verified or a resume point is stored, and must return once
+// that data is durable (e.g. a write cache or a forwarding link is drained).
+// Authenticate is optional as well: when not NULL it replaces
+// ICompFwUpdateBspAuthenticateFWImage, which does not know the component,
+// for images of this component that are not authenticated from a streaming
+// digest. It returns 0 if the staged image is authentic.
+typedef struct
+{
+    UINT32 (*Prepare)           (UINT8 componentId);
+    UINT32 (*EraseSector)       (UINT32 offset, UINT8 componentId);
+    UINT32 (*Write)             (UINT32 offset, UINT8* pData, UINT8 length, 
+                                 UINT8 componentId);
+    UINT32 (*WritePage)         (UINT32 offset, UINT8* pData, UINT16 length, 
+                                 UINT8 componentId);
+    UINT32 (*WritePageAsync)    (UINT32 offset, UINT8* pData, UINT16 length, 
+                                 UINT8 componentId, 
+                                 WRITE_COMPLETED_FUNC writeCompleteHandler);
+    UINT32 (*WriteList)         (const CFU_WRITE_DESCRIPTOR* pList, UINT8 count, 
+                                 UINT8 componentId, 
+                                 WRITE_COMPLETED_FUNC writeCompleteHandler);
+    UINT32 (*Read)              (UINT32 offset, UINT8* pData, UINT16 length, 
+                                 UINT8 componentId);
+    UINT32 (*ReadCurrent)       (UINT32 offset, UINT8* pData, UINT16 length, 
+                                 UINT8 componentId);
+    UINT32 (*CalcCRC)           (UINT16* pCRC, UINT8 componentId);
+    UINT32 (*Flush)             (UINT8 componentId);
+    INT32  (*Authenticate)      (UINT8 componentId);
+} COMPONENT_STORAGE;
+
+// One address range of a component's image, see COMPONENT_REGISTRATION
+typedef struct
+{
+    UINT32 start;
+    UINT32 end;             // First address after the region
+    UINT8 type;             // COMPONENT_REGION_xxx
+} COMPONENT_REGION;
+
+typedef struct COMPONENT_REGISTRATION_STRUCT
+{
+    // Reserved, must be NULL. Components used to be chained through it; the
+    // engine now keeps its own table of registrations (see
+    // MAX_REGISTERED_COMPONENTS). It stays the first member so that
+    // registrations written for that layout, which start with NULL, still
+    // compile and are read the same way.
+    struct COMPONENT_REGISTRATION_STRUCT* pNext;
+    const ICOMPONENT_INTERFACE interface;
+    const UINT8 componentId;
+    const UINT8 flags;      // COMPONENT_FLAG_xxx
+    // Flash page size of the component, a power of two. When non zero
+    // (and CFU_WRITE_COALESCING is enabled) content blocks are gathered and
+    // written a page at a time through ICompFwUpdateBspWritePage.
+    const UINT16 writePageSize;
+    // Erase sector size of the component, a power of two. When non zero
+    // (and CFU_LAZY_ERASE is enabled) ICompFwUpdateBspPrepare must not erase
+    // the staging area; each sector is erased through
+    // ICompFwUpdateBspEraseSector the first time a write touches it.
+    const UINT32 eraseSectorSize;
+    // Time without content after which an update of the component is
+    // abandoned, 0 for CFU_INACTIVITY_TIMEOUT_MS.
+    const UINT32 inactivityTimeoutMs;
+    // Number of bytes from the start of the image covered by the streaming
+    // digest, 0 for all of them. Lets a signature stored after the signed
+    // part of the image be left out of the digest.
+    const UINT32 digestLength;
+    // Address map of the image, sorted by start address and not overlapping.
+    // When not NULL (and CFU_REGION_CHECK is enabled) every block must lie
+    // in regions that follow each other without a gap and are not reserved,
+    // or it is rejected with FIRMWARE_UPDATE_STATUS_ERROR_INVALID_ADDR
+    // before it reaches the BSP. The source of a delta copy is checked the
+    // same way against the running image (with CFU_DELTA_PAYLOAD).
+    const COMPONENT_REGION* pRegions;
+    const UINT8 regionCount;
+    // Storage of the staging area, NULL for the ICompFwUpdateBspXxx
+    // functions. Lets components on different memories (internal flash,
+    // external flash, another chip) each have their own. The write strategy
+    // is still chosen by writePageSize, eraseSectorSize and flags.
+    const COMPONENT_STORAGE* pStorage;
+} COMPONENT_REGISTRATION;
+
+//****************************************************************************
+//
+//                          GLOBAL VARIABLE EXTERNS
+//
+//****************************************************************************
+
+//****************************************************************************
+//
+//                          GLOBAL FUNCTION EXTERNS
+//
+//****************************************************************************
+void IComponentFirmwareUpdateRegisterComponent(COMPONENT_REGISTRATION* pRegistration);
+void IComponentFirmwareUpdateRefreshVersion(UINT8 componentId);
@@ -0,0 +1,278 @@
+/*++
+    This file is part of Component Firmware Update (CFU), licensed under
+    the MIT License (MIT).
+
+    Copyright (c) Microsoft Corporation. All rights reserved.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+Module Name:
+
+    Sha256.c
+
+Abstract:
+
+    Incremental SHA-256 (FIPS 180-4) used by the component firmware update
+    engine. Whole blocks are compressed in portable C, or by a hash
+    accelerator through ICompFwUpdateBspSha256Blocks when CFU_SHA256_BSP is
+    set.
+
+Environment:
+
+    Firmware driver.
+--*/
+//****************************************************************************
+//
+//                               INCLUDES
+//
+//****************************************************************************
+#include <string.h>
+#include "coretypes.h"
+#include "ComponentFwUpdateConfig.h"
+#include "ICompFwUpdateBsp.h"
+#include "Sha256.h"
+
+//****************************************************************************
+//
+//                                  DEFINES
+//
+//****************************************************************************
+#define ROTR(x, n)              (((x) >> (n)) | ((x) << (32 - (n))))
+#define CH(x, y, z)             (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z)            (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define SIGMA0(x)               (ROTR(x, 2) ^ ROTR(x, 13) ^ ROTR(x, 22))
+#define SIGMA1(x)               (ROTR(x, 6) ^ ROTR(x, 11) ^ ROTR(x, 25))
+#define GAMMA0(x)               (ROTR(x, 7) ^ ROTR(x, 18) ^ ((x) >> 3))
+#define GAMMA1(x)               (ROTR(x, 17) ^ ROTR(x, 19) ^ ((x) >> 10))
+
+//****************************************************************************
+//
+//                              STATIC CONSTANTS
+//
+//****************************************************************************
+static const UINT32 s_sha256InitialState[8] =
+{
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+    0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+static const UINT32 s_sha256RoundConstants[64] =
+{
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5,
+    0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3,
+    0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC,
+    0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7,
+    0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13,
+    0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3,
+    0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5,
+    0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
+    0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+//****************************************************************************
+//
+//                              FUNCTION CODE
+//
+//****************************************************************************
+
+//****************************************************************************
+//
+// _Sha256Blocks - Run the SHA-256 compression function over whole blocks,
+//                 on the hash accelerator with CFU_SHA256_BSP.
+//
+// Input Parameters
+//      UINT32* pState - The eight word hash state to update.
+//      const UINT8* pData - The blocks.
+//      UINT32 blockCount - Number of 64 byte blocks in pData.
+//
+//****************************************************************************
+static void _Sha256Blocks(UINT32* pState, const UINT8* pData, UINT32 blockCount)
+{
+#if CFU_SHA256_BSP
+    ICompFwUpdateBspSha256Blocks(pState, pData, blockCount);
+#else
+    Sha256Blocks(pState, pData, blockCount);
+#endif
+}
+
+//****************************************************************************
+//
+//                              GLOBAL FUNCTIONS
+//
+//****************************************************************************
+
+//****************************************************************************
+//
+// Sha256Blocks - Run the SHA-256 compression function over whole blocks in
+//                portable C. With CFU_SHA256_BSP it is only called by an
+//                ICompFwUpdateBspSha256Blocks that falls back to it, e.g.
+//                for blocks the accelerator cannot take, and is otherwise
+//                left out by a linker that drops unused sections.
+//
+// Input Parameters
+//      UINT32* pState - The eight word hash state to update.
+//      const UINT8* pData - The blocks.
+//      UINT32 blockCount - Number of 64 byte blocks in pData.
+//
+//****************************************************************************
+void Sha256Blocks(UINT32* pState, const UINT8* pData, UINT32 blockCount)
+{
+    UINT32 w[16];
+    UINT32 a, b, c, d, e, f, g, h;
+    UINT32 t1, t2;
+    UINT8 i;
+
+    while (blockCount--)
+    {
+        a = pState[0]; b = pState[1]; c = pState[2]; d = pState[3];
+        e = pState[4]; f = pState[5]; g = pState[6]; h = pState[7];
+
+        // The message schedule is kept as a rolling window of 16 words
+        for (i = 0; i < 64; i++)
+        {
+            if (i < 16)
+            {
+                w[i] = ((UINT32)pData[4 * i] << 24) | ((UINT32)pData[4 * i + 1] << 16) |
+                       ((UINT32)pData[4 * i + 2] << 8) | (UINT32)pData[4 * i + 3];
+            }
+            else
+            {
+                w[i & 15] += GAMMA1(w[(i - 2) & 15]) + w[(i - 7) & 15] + 
+                             GAMMA0(w[(i - 15) & 15]);
+            }
+
+            t1 = h + SIGMA1(e) + CH(e, f, g) + s_sha256RoundConstants[i] + w[i & 15];
+            t2 = SIGMA0(a) + MAJ(a, b, c);
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+
+        pState[0] += a; pState[1] += b; pState[2] += c; pState[3] += d;
+        pState[4] += e; pState[5] += f; pState[6] += g; pState[7] += h;
+
+        pData += SHA256_BLOCK_SIZE;
+    }
+}
+
+//****************************************************************************
+//
+// Sha256Init - Start a SHA-256 computation.
+//
+// Input Parameters
+//      SHA256_CONTEXT* pContext - The context to initialize.
+//
+//****************************************************************************
+void Sha256Init(SHA256_CONTEXT* pContext)
+{
+    memcpy(pContext->state, s_sha256InitialState, sizeof(pContext->state));
+    pContext->length = 0;
+}
+
+//****************************************************************************
+//
+// Sha256Update - Continue a SHA-256 computation. Whole blocks of pData are
+//                compressed in place; only a partial block is buffered.
+//
+// Input Parameters
+//      SHA256_CONTEXT* pContext - The computation.
+//      const UINT8* pData - The data to add.
+//      UINT32 length - The number of bytes in pData.
+//
+//****************************************************************************
+void Sha256Update(SHA256_CONTEXT* pContext, const UINT8* pData, UINT32 length)
+{
+    UINT32 buffered = pContext->length % SHA256_BLOCK_SIZE;
+
+    pContext->length += length;
+
+    if (buffered > 0)
+    {
+        UINT32 fill = SHA256_BLOCK_SIZE - buffered;
+
+        if (length < fill)
+        {
+            memcpy(&pContext->buffer[buffered], pData, length);
+            return;
+        }
+
+        memcpy(&pContext->buffer[buffered], pData, fill);
+        _Sha256Blocks(pContext->state, pContext->buffer, 1);
+        pData += fill;
+        length -= fill;
+    }
+
+    if (length >= SHA256_BLOCK_SIZE)
+    {
+        _Sha256Blocks(pContext->state, pData, length / SHA256_BLOCK_SIZE);
+        pData += length - (length % SHA256_BLOCK_SIZE);
+        length %= SHA256_BLOCK_SIZE;
+    }
+
+    memcpy(pContext->buffer, pData, length);
+}
+
+//****************************************************************************
+//
+// Sha256Final - Pad the message and produce the digest. The context must be
+//               initialized again before it is reused.
+//
+// Input Parameters
+//      SHA256_CONTEXT* pContext - The computation.
+//      UINT8* pDigest - Receives the SHA256_DIGEST_SIZE byte digest.
+//
+//****************************************************************************
+void Sha256Final(SHA256_CONTEXT* pContext, UINT8* pDigest)
+{
+    UINT32 buffered = pContext->length % SHA256_BLOCK_SIZE;
+    UINT32 bitLengthHigh = pContext->length >> 29;
+    UINT32 bitLengthLow = pContext->length << 3;
+    UINT8 i;
+
+    pContext->buffer[buffered++] = 0x80;
+
+    if (buffered > (SHA256_BLOCK_SIZE - 8))
+    {
+        memset(&pContext->buffer[buffered], 0, SHA256_BLOCK_SIZE - buffered);
+        _Sha256Blocks(pContext->state, pContext->buffer, 1);
+        buffered = 0;
+    }
+
+    memset(&pContext->buffer[buffered], 0, SHA256_BLOCK_SIZE - 8 - buffered);
+
+    // Message length in bits, big endian
+    for (i = 0; i < 4; i++)
+    {
+        pContext->buffer[SHA256_BLOCK_SIZE - 8 + i] = (UINT8)(bitLengthHigh >> (24 - 8 * i));
+        pContext->buffer[SHA256_BLOCK_SIZE - 4 + i] = (UINT8)(bitLengthLow >> (24 - 8 * i));
+    }
+
+    _Sha256Blocks(pContext->state, pContext->buffer, 1);
+
+    for (i = 0; i < SHA256_DIGEST_SIZE; i++)
+    {
+        pDigest[i] = (UINT8)(pContext->state[i / 4] >> (24 - 8 * (i % 4)));
+    }
+}
@@ -0,0 +1,84 @@
+/*++
+    This file is part of Component Firmware Update (CFU), licensed under
+    the MIT License (MIT).
+
+    Copyright (c) Microsoft Corporation. All rights reserved.
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+Module Name:
+
+    Sha256.h
+
+Abstract:
+
+    Incremental SHA-256 used by the component firmware update engine to
+    digest an image while it is written.
+
+Environment:
+
+    Firmware driver.
+--*/
+#pragma once
+
+//****************************************************************************
+//
+//                               INCLUDES
+//
+//****************************************************************************
+#include "coretypes.h"
+
+//****************************************************************************
+//
+//                                  DEFINES
+//
+//****************************************************************************
+#define SHA256_BLOCK_SIZE                       (64)
+#define SHA256_DIGEST_SIZE                      (32)
+
+//****************************************************************************
+//
+//                                  TYPEDEFS
+//
+//****************************************************************************
+typedef struct
+{
+    UINT32 state[8];
+    UINT32 length;                  // Bytes hashed so far
+    UINT8 buffer[SHA256_BLOCK_SIZE];// Partial block, length % 64 bytes
+} SHA256_CONTEXT;
+
+//****************************************************************************
+//
+//                          GLOBAL FUNCTION EXTERNS
+//
+//****************************************************************************
+
+// Start a SHA-256 computation.
+void Sha256Init(SHA256_CONTEXT* pContext);
+
+// Continue a SHA-256 computation over length bytes of pData.
+void Sha256Update(SHA256_CONTEXT* pContext, const UINT8* pData, UINT32 length);
+
+// Finish a SHA-256 computation and store the digest in pDigest.
+void Sha256Final(SHA256_CONTEXT* pContext, UINT8* pDigest);
+
+// Compress blockCount whole 64 byte blocks into the eight word state in
+// portable C, for an ICompFwUpdateBspSha256Blocks without an accelerator.
+void Sha256Blocks(UINT32* pState, const UINT8* pData, UINT32 blockCount);